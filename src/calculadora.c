@@ -9,6 +9,42 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+/*
+ * Suporte a threads (pthreads). O build do Eclipse/MinGW não liga com
+ * pthreads, então no Windows as operações paralelas rodam sequencialmente.
+ * Defina CALC_SEM_THREADS para forçar o modo sequencial em qualquer sistema.
+ */
+#if defined(_WIN32) && !defined(CALC_SEM_THREADS)
+#define CALC_SEM_THREADS
+#endif
+#ifndef CALC_SEM_THREADS
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#endif
+
+/* Modo servidor: socket de domínio Unix e pool de threads (só POSIX). */
+#if !defined(_WIN32) && !defined(CALC_SEM_THREADS)
+#define CALC_SERVIDOR
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#endif
+
+/* Identificador do processo, usado nos nomes de arquivos temporários. */
+#ifdef _WIN32
+#include <process.h>
+#define calc_pid() ((unsigned long)_getpid())
+#else
+#include <unistd.h>
+#define calc_pid() ((unsigned long)getpid())
+#endif
 
 /*
  * Representa um inteiro arbitrariamente grande.
@@ -89,6 +125,16 @@ int big_comparar_abs(const BigInt *a, const BigInt *b) {
     return 0;
 }
 
+/* Hash FNV-1a de 64 bits sobre o sinal e os dígitos de um BigInt. */
+uint64_t big_hash(const BigInt *x) {
+    uint64_t h = 1469598103934665603ULL;
+    h = (h ^ (uint64_t)(big_eh_zero(x) ? 1 : x->sinal + 2)) * 1099511628211ULL;
+    for (int i = 0; i < x->n; i++) {
+        h = (h ^ (uint64_t)x->digitos[i]) * 1099511628211ULL;
+    }
+    return h;
+}
+
 /* Subtrai módulos assumindo a >= b e ambos não negativos. */
 BigInt *big_subtrair_abs(const BigInt *a, const BigInt *b) {
     BigInt *resultado = big_criar_zero(a->n);
@@ -211,36 +257,84 @@ void big_destruir(BigInt *x) {
 }
 
 /*
- * Imprime um BigInt em stdout, respeitando o sinal.
+ * Escreve um BigInt no arquivo f, respeitando o sinal.
  * Por construção, zero é armazenado como n=1, digitos[0]=0 e sinal=+1.
  */
-void big_imprimir(const BigInt *x) {
+void big_escrever(FILE *f, const BigInt *x) {
     if (x == NULL) {
-        printf("(null)");
+        fputs("(null)", f);
         return;
     }
-    int eh_zero = (x->n == 1 && x->digitos[0] == 0);
-    if (x->sinal < 0 && !eh_zero) {
-        printf("-");
+    if (x->sinal < 0 && !big_eh_zero(x)) {
+        fputc('-', f);
     }
-    /* Imprime do dígito mais significativo para o menos significativo */
+    /* Escreve do dígito mais significativo para o menos significativo */
     for (int i = x->n - 1; i >= 0; i--) {
-        printf("%d", x->digitos[i]);
+        fputc('0' + x->digitos[i], f);
+    }
+}
+
+/*
+ * Escreve um número em ponto fixo: x representa x / 10^casas.
+ * Apenas as primeiras "casas_exibidas" casas decimais são escritas (truncadas).
+ */
+void big_escrever_fixo(FILE *f, const BigInt *x, int casas, int casas_exibidas) {
+    if (x == NULL) {
+        fputs("(null)", f);
+        return;
+    }
+    if (casas_exibidas > casas) casas_exibidas = casas;
+    if (x->sinal < 0 && !big_eh_zero(x)) {
+        fputc('-', f);
+    }
+    /* Parte inteira: dígitos acima da posição "casas" (ou 0). */
+    if (x->n <= casas) {
+        fputc('0', f);
+    }
+    for (int i = x->n - 1; i >= casas; i--) {
+        fputc('0' + x->digitos[i], f);
+    }
+    if (casas_exibidas <= 0) return;
+    fputc('.', f);
+    for (int i = casas - 1; i >= casas - casas_exibidas; i--) {
+        fputc('0' + ((i < x->n) ? x->digitos[i] : 0), f);
     }
 }
 
+/* Imprime um BigInt em stdout, respeitando o sinal. */
+void big_imprimir(const BigInt *x) {
+    big_escrever(stdout, x);
+}
+
 /* funcao de somar inteiros */
 BigInt* big_somar(const BigInt *a, const BigInt *b) {
-   
+    /*sinais diferentes: subtrai o menor modulo do maior, com emprestimo*/
+    if (a->sinal != b->sinal && !big_eh_zero(a) && !big_eh_zero(b)) {
+        const BigInt *maior = (big_comparar_abs(a, b) >= 0) ? a : b;
+        const BigInt *menor = (maior == a) ? b : a;
+        BigInt *resultado = big_subtrair_abs(maior, menor);
+        if (!resultado) return NULL;
+        resultado->sinal = maior->sinal;
+        big_normalizar(resultado);
+        return resultado;
+    }
+
     int auxiliar = 0;
     int i = 0;
     /*variavel que verifica qual dos valores é maior para o loop*/
     int maximovalor = (a->n > b->n) ? a->n : b->n;
     /*set de memoria do resultado*/
     BigInt *respostafinalsoma = (BigInt *)malloc(sizeof(BigInt));
+    if (!respostafinalsoma) return NULL;
+    /*mesmo sinal: soma os modulos e mantem o sinal*/
+    respostafinalsoma->sinal = big_eh_zero(a) ? b->sinal : a->sinal;
    
     /*set espaço maior*/
-    respostafinalsoma->digitos = (int *)malloc((maximovalor * 2) * sizeof(int));
+    respostafinalsoma->digitos = (int *)malloc((maximovalor + 1) * sizeof(int));
+    if (!respostafinalsoma->digitos) {
+        free(respostafinalsoma);
+        return NULL;
+    }
     /*loop que percorre os vetores*/
     for (i = 0; i < maximovalor; i++) {
         /*completa as informações faltantes com 0 para somar os vetores em a */
@@ -260,39 +354,16 @@ BigInt* big_somar(const BigInt *a, const BigInt *b) {
     } else {
         respostafinalsoma->n = maximovalor;
     }
+    big_normalizar(respostafinalsoma);
     return respostafinalsoma;
 }
 
+/* a - b calculado como a + (-b). */
 BigInt* big_subtrair(const BigInt *a, const BigInt *b) {
-    int auxiliar = 0;
-    int i = 0;
-    /*variavel que verifica qual dos valores é maior para o loop*/
-    int maximovalor = (a->n > b->n) ? a->n : b->n;
-    /*set de memoria do resultado*/
-    BigInt *respostafinalsubtrair = (BigInt *)malloc(sizeof(BigInt));
-   
-    /*set espaço maior*/
-    respostafinalsubtrair->digitos = (int *)malloc((maximovalor * 2) * sizeof(int));
-    /*loop que percorre os vetores*/
-    for (i = 0; i < maximovalor; i++) {
-        /*completa as informações faltantes com 0 para somar os vetores em a */
-        int valor_a = (i < a->n) ? a->digitos[i] : 0;
-       /*mesma logica para b*/
-        int valor_b = (i < b->n) ? b->digitos[i] : 0;
-        /*soma as colunas mais o auxiliar*/
-        int subtracao = valor_a - valor_b - auxiliar;
-        respostafinalsubtrair->digitos[i] = subtracao % 10;
-        /*utiliza o auxiliar */
-        auxiliar = subtracao / 10;
-    }
-    /*considera se tem algo no auxiliar salva ele na soma*/
-    if (auxiliar > 0) {
-        respostafinalsubtrair->digitos[i] = auxiliar;
-        respostafinalsubtrair->n = maximovalor + 1;
-    } else {
-        respostafinalsubtrair->n = maximovalor;
-    }
-    return respostafinalsubtrair;
+    /*copia rasa de b com o sinal trocado (compartilha os digitos)*/
+    BigInt menos_b = *b;
+    menos_b.sinal = -b->sinal;
+    return big_somar(a, &menos_b);
 }
 
 /*implanta função de multiplicação*/
@@ -302,8 +373,14 @@ BigInt* big_multiplicar(const BigInt *a, const BigInt *b) {
 
     /*aloca o bigint */
     BigInt *resultado = malloc(sizeof(BigInt));
+    if (!resultado) return NULL;
     resultado->digitos = calloc(tamanho, sizeof(int));
+    if (!resultado->digitos) {
+        free(resultado);
+        return NULL;
+    }
     resultado->n = tamanho;
+    resultado->sinal = a->sinal * b->sinal;
 
     /*multiplicacao dos digitos 1 por 1*/
     for (int i = 0; i < a->n; i++) {
@@ -318,10 +395,34 @@ BigInt* big_multiplicar(const BigInt *a, const BigInt *b) {
         if (auxiliar)
             resultado->digitos[i + b->n] += auxiliar;
     }
+    /*remove zeros a esquerda (e o sinal de -0)*/
+    big_normalizar(resultado);
     return resultado;
 }
 
 
+/*
+ * Passos da divisão longa para os dígitos de..ate do dividendo (do mais para
+ * o menos significativo), comparando só os módulos: atualiza *resto e grava
+ * os dígitos do quociente. Retorna 0 ou -1 em erro de memória.
+ */
+static int divisao_longa_passos(const BigInt *dividendo, const BigInt *divisor,
+                                int de, int ate, BigInt **resto, BigInt *quociente) {
+    for (int i = de; i >= ate; i--) {
+        if (big_multiplicar_por10_adicionar(*resto, dividendo->digitos[i]) != 0) return -1;
+        int q_digit = 0;
+        while (big_comparar_abs(*resto, divisor) >= 0) {
+            BigInt *novo_resto = big_subtrair_abs(*resto, divisor);
+            if (!novo_resto) return -1;
+            big_destruir(*resto);
+            *resto = novo_resto;
+            q_digit++;
+        }
+        quociente->digitos[i] = q_digit;
+    }
+    return 0;
+}
+
 /* Divide dois BigInt e retorna quociente; resto opcionalmente é retornado em resto_out. */
 BigInt *big_dividir_mod(const BigInt *dividendo, const BigInt *divisor, BigInt **resto_out) {
     if (!dividendo || !divisor) return NULL;
@@ -351,29 +452,13 @@ BigInt *big_dividir_mod(const BigInt *dividendo, const BigInt *divisor, BigInt *
     }
     quociente->n = dividendo_abs->n;
     /* Algoritmo de divisão longa: percorre dos dígitos mais significativos para os menos. */
-    for (int i = dividendo_abs->n - 1; i >= 0; i--) {
-        if (big_multiplicar_por10_adicionar(resto, dividendo_abs->digitos[i]) != 0) {
-            big_destruir(dividendo_abs);
-            big_destruir(divisor_abs);
-            big_destruir(quociente);
-            big_destruir(resto);
-            return NULL;
-        }
-        int q_digit = 0;
-        while (big_comparar_abs(resto, divisor_abs) >= 0) {
-            BigInt *novo_resto = big_subtrair_abs(resto, divisor_abs);
-            if (!novo_resto) {
-                big_destruir(dividendo_abs);
-                big_destruir(divisor_abs);
-                big_destruir(quociente);
-                big_destruir(resto);
-                return NULL;
-            }
-            big_destruir(resto);
-            resto = novo_resto;
-            q_digit++;
-        }
-        quociente->digitos[i] = q_digit;
+    if (divisao_longa_passos(dividendo_abs, divisor_abs, dividendo_abs->n - 1, 0,
+                             &resto, quociente) != 0) {
+        big_destruir(dividendo_abs);
+        big_destruir(divisor_abs);
+        big_destruir(quociente);
+        big_destruir(resto);
+        return NULL;
     }
     big_normalizar(quociente);
     /* Define sinais de acordo com as regras matemáticas. */
@@ -436,137 +521,1912 @@ BigInt *big_mdc(const BigInt *a, const BigInt *b) {
         y = r;
     }
 
+    big_destruir(y);
     return x;
 }
 
 /* -------------------------------------------------------------------------
- * Funções da calculadora simples (versão com int / long long)
+ * Acumulador BigInt com propagação de "vai-um" adiada
  * ------------------------------------------------------------------------- */
-void somar(int a, int b) {
-    printf("A soma é: %d\n", a + b);
+
+/*
+ * Acumulador para longas cadeias de somas, subtrações e multiplica-acumula.
+ * As colunas guardam valores em base 10 sem propagar o "vai-um" (forma
+ * redundante): cada coluna pode passar de 9 ou ficar negativa. A normalização
+ * só acontece quando o valor é lido ou quando as colunas se aproximam do
+ * limite de um long long.
+ * - sinal: +1 ou -1, aplicado ao valor inteiro das colunas
+ * - n: quantidade de colunas em uso
+ * - capacidade: colunas alocadas
+ * - carga: limite superior para |colunas[i]| desde a última normalização
+ * - colunas: colunas[0] é a menos significativa
+ */
+typedef struct {
+    int sinal;
+    int n;
+    int capacidade;
+    long long carga;
+    long long *colunas;
+} BigAcumulador;
+
+/* Margem de segurança para as colunas antes de forçar uma normalização. */
+#define ACUM_LIMITE_CARGA (1LL << 62)
+
+/* Cria um acumulador valendo zero. */
+BigAcumulador *big_acum_criar(int capacidade) {
+    if (capacidade < 1) capacidade = 1;
+    BigAcumulador *acc = (BigAcumulador *)malloc(sizeof(BigAcumulador));
+    if (!acc) return NULL;
+    acc->colunas = (long long *)calloc(capacidade, sizeof(long long));
+    if (!acc->colunas) {
+        free(acc);
+        return NULL;
+    }
+    acc->sinal = 1;
+    acc->n = 1;
+    acc->capacidade = capacidade;
+    acc->carga = 0;
+    return acc;
 }
-void subtrair(int a, int b) {
-    printf("A subtração é: %d\n", a - b);
+
+/* Libera a memória associada a um acumulador. */
+void big_acum_destruir(BigAcumulador *acc) {
+    if (acc == NULL) return;
+    free(acc->colunas);
+    free(acc);
 }
-void multiplicar(int a, int b) {
-    printf("A multiplicação é: %d\n", a * b);
+
+/* Garante espaço para "n" colunas, zerando as novas. Retorna 0 se sucesso. */
+static int big_acum_reservar(BigAcumulador *acc, int n) {
+    if (n <= acc->capacidade) return 0;
+    int nova = acc->capacidade * 2;
+    if (nova < n) nova = n;
+    long long *novo = (long long *)realloc(acc->colunas, nova * sizeof(long long));
+    if (!novo) return -1;
+    memset(novo + acc->capacidade, 0, (nova - acc->capacidade) * sizeof(long long));
+    acc->colunas = novo;
+    acc->capacidade = nova;
+    return 0;
 }
-void dividir(int a, int b) {
-    if (b == 0) {
-        printf("Erro: divisão por zero não é permitida.\n");
-        return;
+
+/*
+ * Propaga os "vai-um" pendentes, deixando cada coluna entre 0 e 9.
+ * Usa divisão arredondada para baixo, de modo que colunas negativas viram
+ * empréstimos. Se o valor total ficar negativo, inverte o sinal do
+ * acumulador e normaliza o módulo. Retorna 0 se sucesso.
+ */
+int big_acum_normalizar(BigAcumulador *acc) {
+    if (!acc) return -1;
+    for (int passo = 0; passo < 2; passo++) {
+        long long vai_um = 0;
+        int i = 0;
+        for (; i < acc->n; i++) {
+            long long v = acc->colunas[i] + vai_um;
+            long long d = v % 10;
+            if (d < 0) d += 10;
+            acc->colunas[i] = d;
+            vai_um = (v - d) / 10;
+        }
+        /* "Vai-um" positivo: cresce o número com novas colunas. */
+        while (vai_um > 0) {
+            if (big_acum_reservar(acc, acc->n + 1) != 0) return -1;
+            acc->colunas[acc->n++] = vai_um % 10;
+            vai_um /= 10;
+        }
+        if (vai_um == 0) break;
+        /*
+         * Empréstimo final: o valor é colunas - |vai_um| * 10^n < 0.
+         * Guarda o empréstimo numa coluna extra, troca o sinal de todas as
+         * colunas e normaliza de novo (agora o resultado é positivo).
+         */
+        if (big_acum_reservar(acc, acc->n + 1) != 0) return -1;
+        acc->colunas[acc->n++] = vai_um;
+        for (i = 0; i < acc->n; i++) {
+            acc->colunas[i] = -acc->colunas[i];
+        }
+        acc->sinal = -acc->sinal;
     }
-    printf("A divisão é: %d\n", a / b);
+    while (acc->n > 1 && acc->colunas[acc->n - 1] == 0) {
+        acc->n--;
+    }
+    if (acc->n == 1 && acc->colunas[0] == 0) {
+        acc->sinal = 1;
+    }
+    acc->carga = 9;
+    return 0;
 }
 
-/* Gera um número pseudoaleatório com quantidade de dígitos controlada por n */
-void seed(int seed_value, int n) {
-    srand(seed_value);
-    printf("Número gerado: ");
-    /* Primeiro dígito não pode ser zero */
-    printf("%d", rand() % 9 + 1);
-    for (int i = 1; i < n; i++) {
-        printf("%d", rand() % 10);
+/* Normaliza antecipadamente se somar "incremento" à carga puder estourar. */
+static int big_acum_preparar(BigAcumulador *acc, long long incremento, int colunas) {
+    if (acc->carga > ACUM_LIMITE_CARGA - incremento) {
+        if (big_acum_normalizar(acc) != 0) return -1;
     }
-    printf("\n");
+    if (big_acum_reservar(acc, colunas) != 0) return -1;
+    if (colunas > acc->n) acc->n = colunas;
+    acc->carga += incremento;
+    return 0;
+}
+
+/* Soma (direcao = +1) ou subtrai (direcao = -1) x no acumulador. */
+static int big_acum_adicionar(BigAcumulador *acc, const BigInt *x, int direcao) {
+    if (!acc || !x) return -1;
+    if (big_acum_preparar(acc, 9, x->n) != 0) return -1;
+    long long fator = (long long)(direcao * x->sinal * acc->sinal);
+    for (int i = 0; i < x->n; i++) {
+        acc->colunas[i] += fator * x->digitos[i];
+    }
+    return 0;
+}
+
+/* acc += x, sem propagar "vai-um". Retorna 0 se sucesso. */
+int big_acum_somar(BigAcumulador *acc, const BigInt *x) {
+    return big_acum_adicionar(acc, x, 1);
+}
+
+/* acc -= x, sem propagar "vai-um". Retorna 0 se sucesso. */
+int big_acum_subtrair(BigAcumulador *acc, const BigInt *x) {
+    return big_acum_adicionar(acc, x, -1);
 }
 
 /*
- * Soma dígito por dígito de dois inteiros comuns, simulando soma de "números grandes".
- * Ainda está usando int/long long, mas a lógica serve como base para BigInt.
+ * acc += a * b (multiplica-acumula). Os produtos dígito a dígito são somados
+ * direto nas colunas; cada coluna recebe no máximo 81 * min(a->n, b->n).
  */
-void soma_por_digitos(int a, int b) {
-    long long a_long = (long long)a;
-    long long b_long = (long long)b;
-    int resultado[200];
-    int i = 0;
-    int sobra = 0;
-    while (a_long > 0 || b_long > 0 || sobra > 0) {
-        int d1 = a_long % 10;
-        int d2 = b_long % 10;
-        int soma = d1 + d2 + sobra;
-        resultado[i++] = soma % 10;
-        sobra = soma / 10;
-        a_long /= 10;
-        b_long /= 10;
+int big_acum_mac(BigAcumulador *acc, const BigInt *a, const BigInt *b) {
+    if (!acc || !a || !b) return -1;
+    int menor = (a->n < b->n) ? a->n : b->n;
+    if (big_acum_preparar(acc, 81LL * menor, a->n + b->n) != 0) return -1;
+    long long fator = (long long)(a->sinal * b->sinal * acc->sinal);
+    for (int i = 0; i < a->n; i++) {
+        long long ai = fator * a->digitos[i];
+        if (ai == 0) continue;
+        long long *linha = acc->colunas + i;
+        for (int j = 0; j < b->n; j++) {
+            linha[j] += ai * b->digitos[j];
+        }
     }
-    printf("Resultado: ");
-    for (int j = i - 1; j >= 0; j--) {
-        printf("%d", resultado[j]);
+    return 0;
+}
+
+/* Normaliza o acumulador e devolve seu valor como um novo BigInt. */
+BigInt *big_acum_valor(BigAcumulador *acc) {
+    if (!acc || big_acum_normalizar(acc) != 0) return NULL;
+    BigInt *r = big_criar_zero(acc->n);
+    if (!r) return NULL;
+    r->sinal = acc->sinal;
+    r->n = acc->n;
+    for (int i = 0; i < acc->n; i++) {
+        r->digitos[i] = (int)acc->colunas[i];
     }
-    printf("\n");
+    return r;
 }
 
-/*Implementa um menu para operações int e long long*/
-void menu_inteiros_entrada_usuario() {
-    int num_usuario;
-    int a, b;
-    int continuar = 1;
-    while (continuar) {
-        printf("\n============================================================\n");
-        printf(" CALCULADORA INT \n");
-        printf("============================================================\n");
-        printf(" [1] ➜ Soma\n");
-        printf(" [2] ➜ Subtração\n");
-        printf(" [3] ➜ Multiplicação\n");
-        printf(" [4] ➜ Divisão\n");
-        printf(" [5] ➜ Geração de número aleatório com seed\n");
-        printf(" [6] ➜ Soma dígito por dígito\n");
-        printf("------------------------------------------------------------\n");
-        printf(" [7] ➜ Voltar ao menu principal\n");
-        printf("============================================================\n");
-        printf("Escolha uma opção: ");
-        if (scanf("%d", &num_usuario) != 1) {
-            printf("Entrada inválida.\n");
-            int c;
-            while ((c = getchar()) != '\n' && c != EOF) {}
-            continue;
+/* -------------------------------------------------------------------------
+ * Reduções em árvore: produto e soma de listas, fatorial, binomial, primorial
+ * ------------------------------------------------------------------------- */
+
+/* Abaixo deste tamanho de intervalo não vale a pena criar uma thread. */
+#define REDUCAO_MIN_PARALELO 8
+
+/* Quantidade de núcleos disponíveis (1 quando compilado sem threads). */
+int calc_num_nucleos(void) {
+#ifndef CALC_SEM_THREADS
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return (n > 0) ? (int)n : 1;
+#else
+    return 1;
+#endif
+}
+
+/* Níveis da árvore que podem ser divididos entre threads (log2 dos núcleos). */
+static int reducao_profundidade_paralela(void) {
+    int nucleos = calc_num_nucleos();
+    int profundidade = 0;
+    while ((1 << profundidade) < nucleos) {
+        profundidade++;
+    }
+    return profundidade;
+}
+
+/* Cria um BigInt a partir de um inteiro nativo. */
+BigInt *big_criar_int(long long valor) {
+    unsigned long long modulo = (valor < 0) ? 0ULL - (unsigned long long)valor
+                                            : (unsigned long long)valor;
+    BigInt *x = big_criar_zero(20);
+    if (!x) return NULL;
+    x->n = 0;
+    do {
+        x->digitos[x->n++] = (int)(modulo % 10);
+        modulo /= 10;
+    } while (modulo > 0);
+    x->sinal = (valor < 0) ? -1 : 1;
+    return x;
+}
+
+/* Retorna x * 10^k como novo BigInt (k >= 0). */
+BigInt *big_deslocar10(const BigInt *x, int k) {
+    if (!x || k < 0) return NULL;
+    if (big_eh_zero(x)) return big_criar_zero(1);
+    BigInt *r = big_criar_zero(x->n + k);
+    if (!r) return NULL;
+    r->sinal = x->sinal;
+    r->n = x->n + k;
+    memcpy(r->digitos + k, x->digitos, x->n * sizeof(int));
+    return r;
+}
+
+/* Abaixo deste tamanho (dígitos do menor fator) a multiplicação não é dividida. */
+#define MULT_MIN_PARALELO 512
+
+/* Faixa de linhas [ini, fim) de "a" multiplicada por "b" em uma thread. */
+typedef struct {
+    const BigInt *a;
+    const BigInt *b;
+    int ini;
+    int fim;
+    BigInt *resultado;
+} FaixaProduto;
+
+/* Produto dos módulos da faixa a[ini..fim) por b, em um acumulador próprio. */
+static void *produto_faixa(void *arg) {
+    FaixaProduto *f = (FaixaProduto *)arg;
+    BigInt faixa;
+    faixa.sinal = 1;
+    faixa.n = f->fim - f->ini;
+    faixa.digitos = f->a->digitos + f->ini;
+    BigInt modulo_b = *f->b;
+    modulo_b.sinal = 1;
+    BigAcumulador *acc = big_acum_criar(faixa.n + modulo_b.n);
+    f->resultado = (acc && big_acum_mac(acc, &faixa, &modulo_b) == 0) ? big_acum_valor(acc) : NULL;
+    big_acum_destruir(acc);
+    return NULL;
+}
+
+/*
+ * Multiplica dividindo as linhas do fator maior em 2^profundidade faixas,
+ * cada uma em uma thread com seu acumulador; as parciais são somadas com o
+ * deslocamento da faixa. Fatores pequenos (ou sem profundidade) usam
+ * big_multiplicar direto.
+ */
+static BigInt *big_multiplicar_paralelo(const BigInt *a, const BigInt *b, int profundidade) {
+    if (a->n < b->n) {
+        const BigInt *troca = a;
+        a = b;
+        b = troca;
+    }
+    if (profundidade <= 0 || b->n < MULT_MIN_PARALELO) return big_multiplicar(a, b);
+    int qtd = 1 << profundidade;
+    if (qtd > a->n / MULT_MIN_PARALELO) qtd = a->n / MULT_MIN_PARALELO;
+    if (qtd < 2) return big_multiplicar(a, b);
+    FaixaProduto *faixas = (FaixaProduto *)calloc(qtd, sizeof(FaixaProduto));
+    if (!faixas) return NULL;
+    for (int i = 0; i < qtd; i++) {
+        faixas[i].a = a;
+        faixas[i].b = b;
+        faixas[i].ini = (int)((long long)a->n * i / qtd);
+        faixas[i].fim = (int)((long long)a->n * (i + 1) / qtd);
+    }
+#ifndef CALC_SEM_THREADS
+    pthread_t *threads = (pthread_t *)malloc(qtd * sizeof(pthread_t));
+    int *criada = (int *)calloc(qtd, sizeof(int));
+    for (int i = 1; threads && criada && i < qtd; i++) {
+        criada[i] = pthread_create(&threads[i], NULL, produto_faixa, &faixas[i]) == 0;
+    }
+    produto_faixa(&faixas[0]);
+    for (int i = 1; i < qtd; i++) {
+        if (threads && criada && criada[i]) {
+            pthread_join(threads[i], NULL);
+        } else {
+            produto_faixa(&faixas[i]);
         }
-        switch (num_usuario) {
-            case 1:
-                printf("Digite dois números: ");
-                scanf("%d %d", &a, &b);
-                somar(a, b);
-                break;
-            case 2:
-                printf("Digite dois números: ");
-                scanf("%d %d", &a, &b);
-                subtrair(a, b);
-                break;
-            case 3:
-                printf("Digite dois números: ");
-                scanf("%d %d", &a, &b);
-                multiplicar(a, b);
-                break;
-            case 4:
-                printf("Digite dois números: ");
-                scanf("%d %d", &a, &b);
-                dividir(a, b);
-                break;
-            case 5:
-                printf("Digite o seed e a quantidade de dígitos: ");
-                scanf("%d %d", &a, &b);
-                seed(a, b);
-                break;
-            case 6:
-                printf("Digite dois números: ");
-                scanf("%d %d", &a, &b);
-                soma_por_digitos(a, b);
-                break;
-            case 7:
-                return;
-            default:
-                printf("Opção inválida.\n");
-                break;
+    }
+    free(threads);
+    free(criada);
+#else
+    for (int i = 0; i < qtd; i++) {
+        produto_faixa(&faixas[i]);
+    }
+#endif
+    BigAcumulador *acc = big_acum_criar(a->n + b->n);
+    int ok = acc != NULL;
+    for (int i = 0; i < qtd; i++) {
+        BigInt *deslocada = (ok && faixas[i].resultado)
+                                ? big_deslocar10(faixas[i].resultado, faixas[i].ini) : NULL;
+        ok = deslocada && big_acum_somar(acc, deslocada) == 0;
+        big_destruir(deslocada);
+        big_destruir(faixas[i].resultado);
+    }
+    free(faixas);
+    BigInt *r = ok ? big_acum_valor(acc) : NULL;
+    big_acum_destruir(acc);
+    if (r) {
+        r->sinal = a->sinal * b->sinal;
+        big_normalizar(r);
+    }
+    return r;
+}
+
+/* Intervalo [ini, fim) de uma lista a ser reduzida, possivelmente em outra thread. */
+typedef struct {
+    BigInt *const *valores;
+    int ini;
+    int fim;
+    int profundidade;
+    BigInt *resultado;
+} TarefaReducao;
+
+static BigInt *big_produto_intervalo(BigInt *const *v, int ini, int fim, int profundidade);
+static BigInt *big_soma_intervalo(BigInt *const *v, int ini, int fim, int profundidade);
+
+static void *reducao_produto_thread(void *arg) {
+    TarefaReducao *t = (TarefaReducao *)arg;
+    t->resultado = big_produto_intervalo(t->valores, t->ini, t->fim, t->profundidade);
+    return NULL;
+}
+
+static void *reducao_soma_thread(void *arg) {
+    TarefaReducao *t = (TarefaReducao *)arg;
+    t->resultado = big_soma_intervalo(t->valores, t->ini, t->fim, t->profundidade);
+    return NULL;
+}
+
+/*
+ * Reduz as duas metades de [ini, fim) com "reduzir". Enquanto houver
+ * profundidade paralela, a metade esquerda roda em uma nova thread e a
+ * direita na thread atual.
+ */
+static void reducao_dividir(BigInt *const *v, int ini, int fim, int profundidade,
+                            BigInt *(*reduzir)(BigInt *const *, int, int, int),
+                            void *(*reduzir_thread)(void *),
+                            BigInt **esq, BigInt **dir) {
+    int meio = ini + (fim - ini) / 2;
+#ifndef CALC_SEM_THREADS
+    if (profundidade > 0 && fim - ini >= REDUCAO_MIN_PARALELO) {
+        TarefaReducao tarefa = { v, ini, meio, profundidade - 1, NULL };
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, reduzir_thread, &tarefa) == 0) {
+            *dir = reduzir(v, meio, fim, profundidade - 1);
+            pthread_join(thread, NULL);
+            *esq = tarefa.resultado;
+            return;
         }
     }
+#else
+    (void)reduzir_thread;
+#endif
+    if (profundidade > 0) profundidade--;
+    *esq = reduzir(v, ini, meio, profundidade);
+    *dir = reduzir(v, meio, fim, profundidade);
 }
 
-/*Implementa um menu para operações com bigint*/
-void menu_bigint_entrada_usuario() {
-    int opc = 1;
-    char A[1024], B[1024];
-    while (opc) {
+/* Produto de v[ini..fim) por divisão binária balanceada. */
+static BigInt *big_produto_intervalo(BigInt *const *v, int ini, int fim, int profundidade) {
+    if (fim - ini == 1) return big_copiar(v[ini]);
+    if (fim - ini == 2) return big_multiplicar(v[ini], v[ini + 1]);
+    BigInt *esq = NULL, *dir = NULL;
+    reducao_dividir(v, ini, fim, profundidade, big_produto_intervalo,
+                    reducao_produto_thread, &esq, &dir);
+    /* As duas metades já terminaram: as threads desta profundidade dividem o produto. */
+    BigInt *r = (esq && dir) ? big_multiplicar_paralelo(esq, dir, profundidade) : NULL;
+    big_destruir(esq);
+    big_destruir(dir);
+    return r;
+}
+
+/*
+ * Soma de v[ini..fim). Cada folha da árvore usa um acumulador (sem
+ * propagação de "vai-um" a cada parcela) e as folhas são combinadas em pares.
+ */
+static BigInt *big_soma_intervalo(BigInt *const *v, int ini, int fim, int profundidade) {
+    BigAcumulador *acc = big_acum_criar(v[ini]->n + 1);
+    if (!acc) return NULL;
+    if (profundidade == 0 || fim - ini < REDUCAO_MIN_PARALELO) {
+        for (int i = ini; i < fim; i++) {
+            if (big_acum_somar(acc, v[i]) != 0) {
+                big_acum_destruir(acc);
+                return NULL;
+            }
+        }
+    } else {
+        BigInt *esq = NULL, *dir = NULL;
+        reducao_dividir(v, ini, fim, profundidade, big_soma_intervalo,
+                        reducao_soma_thread, &esq, &dir);
+        int ok = esq && dir && big_acum_somar(acc, esq) == 0 && big_acum_somar(acc, dir) == 0;
+        big_destruir(esq);
+        big_destruir(dir);
+        if (!ok) {
+            big_acum_destruir(acc);
+            return NULL;
+        }
+    }
+    BigInt *r = big_acum_valor(acc);
+    big_acum_destruir(acc);
+    return r;
+}
+
+/* Produto de todos os elementos da lista (1 para lista vazia). */
+BigInt *big_produto_lista(BigInt *const *valores, int qtd) {
+    if (qtd < 0 || (qtd > 0 && !valores)) return NULL;
+    if (qtd == 0) return big_criar_int(1);
+    return big_produto_intervalo(valores, 0, qtd, reducao_profundidade_paralela());
+}
+
+/* Soma de todos os elementos da lista (0 para lista vazia). */
+BigInt *big_soma_lista(BigInt *const *valores, int qtd) {
+    if (qtd < 0 || (qtd > 0 && !valores)) return NULL;
+    if (qtd == 0) return big_criar_zero(1);
+    return big_soma_intervalo(valores, 0, qtd, reducao_profundidade_paralela());
+}
+
+/*
+ * Multiplica uma lista de fatores nativos positivos pela árvore de produtos.
+ * Fatores consecutivos são agrupados em um único long long enquanto não
+ * houver estouro, reduzindo o número de folhas da árvore.
+ */
+static BigInt *big_produto_fatores(const long long *fatores, int qtd) {
+    BigInt **folhas = (BigInt **)calloc(qtd + 1, sizeof(BigInt *));
+    if (!folhas) return NULL;
+    int qtd_folhas = 0;
+    int erro = 0;
+    long long grupo = 1;
+    for (int i = 0; i <= qtd && !erro; i++) {
+        if (i < qtd && grupo <= 999999999999999999LL / fatores[i]) {
+            grupo *= fatores[i];
+            continue;
+        }
+        if (grupo > 1 || (i == qtd && qtd_folhas == 0)) {
+            folhas[qtd_folhas] = big_criar_int(grupo);
+            if (!folhas[qtd_folhas]) erro = 1;
+            else qtd_folhas++;
+        }
+        if (i < qtd) grupo = fatores[i];
+    }
+    BigInt *r = erro ? NULL : big_produto_lista(folhas, qtd_folhas);
+    for (int i = 0; i < qtd_folhas; i++) {
+        big_destruir(folhas[i]);
+    }
+    free(folhas);
+    return r;
+}
+
+/* Crivo de Eratóstenes: devolve os primos <= limite e sua quantidade em *qtd. */
+static long long *crivo_primos(int limite, int *qtd) {
+    *qtd = 0;
+    if (limite < 2) return (long long *)malloc(sizeof(long long));
+    char *composto = (char *)calloc(limite + 1, 1);
+    if (!composto) return NULL;
+    for (long long i = 2; i * i <= limite; i++) {
+        if (composto[i]) continue;
+        for (long long j = i * i; j <= limite; j += i) {
+            composto[j] = 1;
+        }
+    }
+    int total = 0;
+    for (int i = 2; i <= limite; i++) {
+        if (!composto[i]) total++;
+    }
+    long long *primos = (long long *)malloc(total * sizeof(long long));
+    if (primos) {
+        for (int i = 2; i <= limite; i++) {
+            if (!composto[i]) primos[(*qtd)++] = i;
+        }
+    }
+    free(composto);
+    return primos;
+}
+
+/* Calcula n! pela árvore de produtos. */
+BigInt *big_fatorial(int n) {
+    if (n < 0) {
+        printf("Erro: fatorial de número negativo não é definido.\n");
+        return NULL;
+    }
+    if (n < 2) return big_criar_int(1);
+    long long *fatores = (long long *)malloc((n - 1) * sizeof(long long));
+    if (!fatores) return NULL;
+    for (int i = 2; i <= n; i++) {
+        fatores[i - 2] = i;
+    }
+    BigInt *r = big_produto_fatores(fatores, n - 1);
+    free(fatores);
+    return r;
+}
+
+/* Calcula o produto de todos os primos <= n (n#). */
+BigInt *big_primorial(int n) {
+    int qtd;
+    long long *primos = crivo_primos(n, &qtd);
+    if (!primos) return NULL;
+    BigInt *r = big_produto_fatores(primos, qtd);
+    free(primos);
+    return r;
+}
+
+/* Expoente do primo p em n! (fórmula de Legendre). */
+static long long legendre(long long n, long long p) {
+    long long e = 0;
+    while (n > 0) {
+        n /= p;
+        e += n;
+    }
+    return e;
+}
+
+/*
+ * Calcula o binomial C(n, k) sem divisões: fatora C(n, k) em primos pela
+ * fórmula de Legendre e multiplica as potências pela árvore de produtos.
+ */
+BigInt *big_binomial(int n, int k) {
+    if (n < 0) {
+        printf("Erro: binomial com n negativo não é suportado.\n");
+        return NULL;
+    }
+    if (k < 0 || k > n) return big_criar_zero(1);
+    int qtd_primos;
+    long long *primos = crivo_primos(n, &qtd_primos);
+    if (!primos) return NULL;
+    /* Cada primo p contribui com no máximo log_p(n) fatores. */
+    int capacidade = 0;
+    for (int i = 0; i < qtd_primos; i++) {
+        capacidade += (int)(legendre(n, primos[i]) - legendre(k, primos[i])
+                            - legendre(n - k, primos[i]));
+    }
+    long long *fatores = (long long *)malloc((capacidade > 0 ? capacidade : 1) * sizeof(long long));
+    if (!fatores) {
+        free(primos);
+        return NULL;
+    }
+    int qtd = 0;
+    for (int i = 0; i < qtd_primos; i++) {
+        long long e = legendre(n, primos[i]) - legendre(k, primos[i]) - legendre(n - k, primos[i]);
+        while (e-- > 0) {
+            fatores[qtd++] = primos[i];
+        }
+    }
+    BigInt *r = big_produto_fatores(fatores, qtd);
+    free(fatores);
+    free(primos);
+    return r;
+}
+
+/* -------------------------------------------------------------------------
+ * Constantes com precisão arbitrária (pi, e, raiz de 2) por divisão binária
+ * ------------------------------------------------------------------------- */
+
+/* Dígitos extras calculados além do pedido, descartados na saída. */
+#define CONSTANTE_GUARDA 10
+/* Quantidade máxima de blocos gravados no arquivo de checkpoint. */
+#define CONSTANTE_BLOCOS 64
+
+/*
+ * Trinca (P, Q, T) da divisão binária de uma série hipergeométrica
+ *     S(a, b) = soma_{k=a}^{b-1} c(k) * prod_{j=a}^{k} p(j) / q(j)
+ * com P = prod p(j), Q = prod q(j) e T = S * Q.
+ */
+typedef struct {
+    BigInt *p;
+    BigInt *q;
+    BigInt *t;
+} SerieTrinca;
+
+/* Gera a trinca de um único termo k: P = p(k), Q = q(k), T = c(k) * p(k). */
+typedef int (*SerieTermo)(long long k, SerieTrinca *out);
+
+/* Origem das folhas: termos individuais ou blocos já calculados. */
+typedef struct {
+    SerieTermo termo;
+    const SerieTrinca *blocos;
+} SerieFonte;
+
+static void serie_liberar(SerieTrinca *s) {
+    big_destruir(s->p);
+    big_destruir(s->q);
+    big_destruir(s->t);
+    s->p = s->q = s->t = NULL;
+}
+
+/* Preenche a trinca a partir de três inteiros nativos. */
+static int serie_trinca_int(SerieTrinca *out, long long p, long long q, long long t) {
+    out->p = big_criar_int(p);
+    out->q = big_criar_int(q);
+    out->t = big_criar_int(t);
+    if (!out->p || !out->q || !out->t) {
+        serie_liberar(out);
+        return -1;
+    }
+    return 0;
+}
+
+/* Produto de três fatores nativos como BigInt (evita estouro de long long). */
+static BigInt *big_produto3(long long a, long long b, long long c) {
+    BigInt *x = big_criar_int(a);
+    BigInt *y = big_criar_int(b);
+    BigInt *z = big_criar_int(c);
+    BigInt *xy = (x && y) ? big_multiplicar(x, y) : NULL;
+    BigInt *r = (xy && z) ? big_multiplicar(xy, z) : NULL;
+    big_destruir(x);
+    big_destruir(y);
+    big_destruir(z);
+    big_destruir(xy);
+    return r;
+}
+
+/*
+ * Chudnovsky: p(k) = -(6k-5)(2k-1)(6k-1), q(k) = 10939058860032000 k^3,
+ * c(k) = 13591409 + 545140134 k.
+ */
+static int serie_termo_pi(long long k, SerieTrinca *out) {
+    if (k == 0) return serie_trinca_int(out, 1, 1, 13591409);
+    out->p = big_produto3(-(6 * k - 5), 2 * k - 1, 6 * k - 1);
+    out->q = big_produto3(10939058860032000LL, k * k, k);
+    BigInt *c = big_criar_int(13591409 + 545140134 * k);
+    out->t = (out->p && c) ? big_multiplicar(out->p, c) : NULL;
+    big_destruir(c);
+    if (!out->p || !out->q || !out->t) {
+        serie_liberar(out);
+        return -1;
+    }
+    return 0;
+}
+
+/* e = soma 1/k!: p(k) = 1, q(k) = k, c(k) = 1. */
+static int serie_termo_e(long long k, SerieTrinca *out) {
+    return serie_trinca_int(out, 1, (k == 0) ? 1 : k, 1);
+}
+
+/*
+ * raiz(2) = 7/5 * (1 - 1/50)^(-1/2) = 7/5 * soma C(2k, k) / 200^k,
+ * ou seja p(k) = 2k - 1, q(k) = 100k, c(k) = 1.
+ */
+static int serie_termo_raiz2(long long k, SerieTrinca *out) {
+    if (k == 0) return serie_trinca_int(out, 1, 1, 1);
+    return serie_trinca_int(out, 2 * k - 1, 100 * k, 2 * k - 1);
+}
+
+/* Combina [a, m) e [m, b): P = P1 P2, Q = Q1 Q2, T = T1 Q2 + P1 T2. */
+static int serie_combinar(SerieTrinca *esq, SerieTrinca *dir, SerieTrinca *out) {
+    out->p = big_multiplicar(esq->p, dir->p);
+    out->q = big_multiplicar(esq->q, dir->q);
+    out->t = NULL;
+    BigAcumulador *acc = big_acum_criar(esq->t->n + dir->q->n + 1);
+    if (acc && big_acum_mac(acc, esq->t, dir->q) == 0 && big_acum_mac(acc, esq->p, dir->t) == 0) {
+        out->t = big_acum_valor(acc);
+    }
+    big_acum_destruir(acc);
+    serie_liberar(esq);
+    serie_liberar(dir);
+    if (!out->p || !out->q || !out->t) {
+        serie_liberar(out);
+        return -1;
+    }
+    return 0;
+}
+
+static int serie_calcular(const SerieFonte *fonte, long long a, long long b,
+                          int profundidade, SerieTrinca *out);
+
+/* Metade de um intervalo da série calculada em outra thread. */
+typedef struct {
+    const SerieFonte *fonte;
+    long long a;
+    long long b;
+    int profundidade;
+    SerieTrinca resultado;
+    int status;
+} TarefaSerie;
+
+static void *serie_thread(void *arg) {
+    TarefaSerie *t = (TarefaSerie *)arg;
+    t->status = serie_calcular(t->fonte, t->a, t->b, t->profundidade, &t->resultado);
+    return NULL;
+}
+
+/* Divisão binária de [a, b); os níveis de cima dividem o trabalho entre threads. */
+static int serie_calcular(const SerieFonte *fonte, long long a, long long b,
+                          int profundidade, SerieTrinca *out) {
+    out->p = out->q = out->t = NULL;
+    if (b - a == 1) {
+        if (!fonte->blocos) return fonte->termo(a, out);
+        const SerieTrinca *bloco = &fonte->blocos[a];
+        out->p = big_copiar(bloco->p);
+        out->q = big_copiar(bloco->q);
+        out->t = big_copiar(bloco->t);
+        if (!out->p || !out->q || !out->t) {
+            serie_liberar(out);
+            return -1;
+        }
+        return 0;
+    }
+    long long m = a + (b - a) / 2;
+    TarefaSerie esq = { fonte, a, m, profundidade > 0 ? profundidade - 1 : 0, { NULL, NULL, NULL }, -1 };
+    SerieTrinca dir = { NULL, NULL, NULL };
+    int status_dir;
+#ifndef CALC_SEM_THREADS
+    pthread_t thread;
+    if (profundidade > 0 && b - a >= REDUCAO_MIN_PARALELO
+        && pthread_create(&thread, NULL, serie_thread, &esq) == 0) {
+        status_dir = serie_calcular(fonte, m, b, esq.profundidade, &dir);
+        pthread_join(thread, NULL);
+    } else
+#endif
+    {
+        serie_thread(&esq);
+        status_dir = serie_calcular(fonte, m, b, esq.profundidade, &dir);
+    }
+    if (esq.status != 0 || status_dir != 0) {
+        serie_liberar(&esq.resultado);
+        serie_liberar(&dir);
+        return -1;
+    }
+    return serie_combinar(&esq.resultado, &dir, out);
+}
+
+/*
+ * Lê uma linha de tamanho arbitrário (sem o '\n'). Retorna NULL no fim do
+ * arquivo ou em erro de memória; o chamador libera a string com free.
+ */
+char *ler_linha(FILE *f) {
+    int capacidade = 256;
+    int len = 0;
+    char *linha = (char *)malloc(capacidade);
+    if (!linha) return NULL;
+    int c;
+    while ((c = fgetc(f)) != EOF && c != '\n') {
+        if (len + 1 >= capacidade) {
+            capacidade *= 2;
+            char *nova = (char *)realloc(linha, capacidade);
+            if (!nova) {
+                free(linha);
+                return NULL;
+            }
+            linha = nova;
+        }
+        linha[len++] = (char)c;
+    }
+    if (c == EOF && len == 0) {
+        free(linha);
+        return NULL;
+    }
+    if (len > 0 && linha[len - 1] == '\r') len--;
+    linha[len] = '\0';
+    return linha;
+}
+
+/* Lê um BigInt de uma linha do arquivo. Retorna NULL em erro. */
+static BigInt *ler_bigint_linha(FILE *f) {
+    char *linha = ler_linha(f);
+    if (!linha) return NULL;
+    BigInt *x = (linha[0] != '\0') ? big_criar(linha) : NULL;
+    free(linha);
+    return x;
+}
+
+/*
+ * Nome temporário único ("<destino>.<pid>.<n>.tmp") para gravar um arquivo
+ * por inteiro antes de publicá-lo com arquivo_publicar.
+ */
+static void arquivo_temporario(char *temporario, size_t tamanho, const char *destino) {
+#ifndef CALC_SEM_THREADS
+    static atomic_ulong contador;
+    unsigned long serial = atomic_fetch_add(&contador, 1);
+#else
+    static unsigned long contador;
+    unsigned long serial = contador++;
+#endif
+    snprintf(temporario, tamanho, "%s.%lu.%lu.tmp", destino, calc_pid(), serial);
+}
+
+/*
+ * Fecha "f" (gravado em "temporario") e o renomeia para "destino", de modo
+ * que um leitor veja o arquivo antigo ou o novo completo, nunca um parcial.
+ * Retorna 0 em sucesso; em erro o temporário é removido.
+ */
+static int arquivo_publicar(FILE *f, const char *temporario, const char *destino) {
+    int erro = ferror(f);
+    if (fclose(f) != 0 || erro) {
+        remove(temporario);
+        return -1;
+    }
+    if (rename(temporario, destino) == 0) return 0;
+#ifdef _WIN32
+    /* No Windows rename não sobrescreve um destino existente. */
+    remove(destino);
+    if (rename(temporario, destino) == 0) return 0;
+#endif
+    /* No POSIX rename já substitui atomicamente: a falha preserva o destino. */
+    remove(temporario);
+    return -1;
+}
+
+/* Grava um bloco concluído no checkpoint, terminado por "FIM <indice>". */
+static void constante_gravar_bloco(FILE *f, int indice, const SerieTrinca *s) {
+    fprintf(f, "BLOCO %d\n", indice);
+    big_escrever(f, s->p);
+    fputc('\n', f);
+    big_escrever(f, s->q);
+    fputc('\n', f);
+    big_escrever(f, s->t);
+    fprintf(f, "\nFIM %d\n", indice);
+}
+
+/*
+ * Carrega os blocos já concluídos de um checkpoint. O cabeçalho precisa
+ * coincidir com a execução atual; a leitura para no primeiro bloco sem a
+ * linha "FIM" (execução interrompida no meio da gravação).
+ */
+static void constante_carregar_checkpoint(const char *caminho, const char *nome,
+                                          long long termos, int qtd_blocos,
+                                          SerieTrinca *blocos) {
+    FILE *f = fopen(caminho, "r");
+    if (!f) return;
+    char nome_lido[32];
+    long long termos_lidos;
+    int blocos_lidos;
+    if (fscanf(f, "CKPT %31s %lld %d\n", nome_lido, &termos_lidos, &blocos_lidos) != 3
+        || strcmp(nome_lido, nome) != 0 || termos_lidos != termos || blocos_lidos != qtd_blocos) {
+        printf("Aviso: checkpoint '%s' não corresponde a este cálculo; ignorado.\n", caminho);
+        fclose(f);
+        return;
+    }
+    int indice;
+    while (fscanf(f, "BLOCO %d\n", &indice) == 1 && indice >= 0 && indice < qtd_blocos) {
+        SerieTrinca s;
+        s.p = ler_bigint_linha(f);
+        s.q = ler_bigint_linha(f);
+        s.t = ler_bigint_linha(f);
+        char *fim = ler_linha(f);
+        int indice_fim = -1;
+        int completo = fim && sscanf(fim, "FIM %d", &indice_fim) == 1 && indice_fim == indice;
+        free(fim);
+        if (!s.p || !s.q || !s.t || !completo) {
+            serie_liberar(&s);
+            break;
+        }
+        serie_liberar(&blocos[indice]);
+        blocos[indice] = s;
+    }
+    fclose(f);
+}
+
+/*
+ * Soma a série inteira em "qtd_blocos" blocos. Cada bloco concluído é
+ * acrescentado ao checkpoint (se houver), de modo que uma execução
+ * interrompida retoma a partir do primeiro bloco que faltar. Ao retomar, o
+ * checkpoint é regravado só com os blocos válidos antes de receber novos:
+ * acrescentar depois de um final truncado tornaria esses blocos ilegíveis.
+ */
+static int constante_serie(const char *nome, SerieTermo termo, long long termos,
+                           const char *checkpoint, SerieTrinca *out) {
+    int profundidade = reducao_profundidade_paralela();
+    int qtd_blocos = (termos < CONSTANTE_BLOCOS) ? (int)termos : CONSTANTE_BLOCOS;
+    SerieTrinca *blocos = (SerieTrinca *)calloc(qtd_blocos, sizeof(SerieTrinca));
+    if (!blocos) return -1;
+    FILE *ckpt = NULL;
+    if (checkpoint) {
+        constante_carregar_checkpoint(checkpoint, nome, termos, qtd_blocos, blocos);
+        int retomados = 0;
+        for (int i = 0; i < qtd_blocos; i++) {
+            if (blocos[i].p) retomados++;
+        }
+        if (retomados > 0) {
+            printf("Retomando do checkpoint: %d de %d blocos prontos.\n", retomados, qtd_blocos);
+        }
+        char temporario[1024];
+        arquivo_temporario(temporario, sizeof(temporario), checkpoint);
+        ckpt = fopen(temporario, "w");
+        if (ckpt) {
+            fprintf(ckpt, "CKPT %s %lld %d\n", nome, termos, qtd_blocos);
+            for (int i = 0; i < qtd_blocos; i++) {
+                if (blocos[i].p) constante_gravar_bloco(ckpt, i, &blocos[i]);
+            }
+            ckpt = (arquivo_publicar(ckpt, temporario, checkpoint) == 0)
+                       ? fopen(checkpoint, "a") : NULL;
+        }
+        if (!ckpt) printf("Aviso: não foi possível gravar o checkpoint '%s'.\n", checkpoint);
+    }
+    SerieFonte fonte_termos = { termo, NULL };
+    int status = 0;
+    for (int i = 0; i < qtd_blocos && status == 0; i++) {
+        if (blocos[i].p) continue;
+        long long a = termos * i / qtd_blocos;
+        long long b = termos * (i + 1) / qtd_blocos;
+        status = serie_calcular(&fonte_termos, a, b, profundidade, &blocos[i]);
+        if (status == 0 && ckpt) {
+            constante_gravar_bloco(ckpt, i, &blocos[i]);
+            fflush(ckpt);
+        }
+    }
+    if (ckpt) fclose(ckpt);
+    if (status == 0) {
+        SerieFonte fonte_blocos = { NULL, blocos };
+        status = serie_calcular(&fonte_blocos, 0, qtd_blocos, profundidade, out);
+    }
+    for (int i = 0; i < qtd_blocos; i++) {
+        serie_liberar(&blocos[i]);
+    }
+    free(blocos);
+    return status;
+}
+
+/*
+ * Estado da divisão retomável: "DIV <hash a> <hash b> <i>", o resto, os
+ * dígitos do quociente acima de i e "FIM <hash resto> <hash quociente>".
+ */
+static void divisao_gravar_estado(const char *caminho, uint64_t hash_a, uint64_t hash_b,
+                                  int i, const BigInt *resto, const BigInt *quociente) {
+    BigInt parcial;
+    parcial.sinal = 1;
+    parcial.n = quociente->n - (i + 1);
+    parcial.digitos = quociente->digitos + i + 1;
+    while (parcial.n > 1 && parcial.digitos[parcial.n - 1] == 0) parcial.n--;
+    char temporario[1024];
+    arquivo_temporario(temporario, sizeof(temporario), caminho);
+    FILE *f = fopen(temporario, "w");
+    if (!f) return;
+    fprintf(f, "DIV %016llx %016llx %d\n", (unsigned long long)hash_a,
+            (unsigned long long)hash_b, i);
+    big_escrever(f, resto);
+    fputc('\n', f);
+    big_escrever(f, &parcial);
+    fprintf(f, "\nFIM %016llx %016llx\n", (unsigned long long)big_hash(resto),
+            (unsigned long long)big_hash(&parcial));
+    arquivo_publicar(f, temporario, caminho);
+}
+
+/*
+ * Carrega o estado gravado por divisao_gravar_estado se ele for desta
+ * divisão e estiver íntegro. Retorna o próximo dígito do dividendo a
+ * processar (n - 1 quando não há estado) e o resto em *resto.
+ */
+static int divisao_carregar_estado(const char *caminho, const BigInt *a, const BigInt *b,
+                                   uint64_t hash_a, uint64_t hash_b,
+                                   BigInt **resto, BigInt *quociente) {
+    *resto = NULL;
+    FILE *f = fopen(caminho, "r");
+    if (!f) return a->n - 1;
+    char *cabecalho = ler_linha(f);
+    BigInt *r = ler_bigint_linha(f);
+    BigInt *parcial = ler_bigint_linha(f);
+    char *rodape = ler_linha(f);
+    fclose(f);
+    unsigned long long lido_a = 0, lido_b = 0, hash_r = 0, hash_p = 0;
+    int i = -1;
+    char sobra;
+    int ok = cabecalho && sscanf(cabecalho, "DIV %llx %llx %d %c", &lido_a, &lido_b, &i, &sobra) == 3
+             && lido_a == hash_a && lido_b == hash_b && i >= 0 && i < a->n - 1
+             && r && parcial && parcial->n <= a->n - (i + 1) && big_comparar_abs(r, b) < 0
+             && rodape && sscanf(rodape, "FIM %llx %llx %c", &hash_r, &hash_p, &sobra) == 2
+             && hash_r == big_hash(r) && hash_p == big_hash(parcial);
+    free(cabecalho);
+    free(rodape);
+    if (ok) {
+        memcpy(quociente->digitos + i + 1, parcial->digitos, parcial->n * sizeof(int));
+        *resto = r;
+    } else {
+        big_destruir(r);
+    }
+    big_destruir(parcial);
+    return ok ? i : a->n - 1;
+}
+
+/*
+ * Quociente de a / b (a >= 0, b > 0) pela divisão longa, gravando o estado
+ * em "caminho" a cada 1/CONSTANTE_BLOCOS dos dígitos. Uma execução
+ * interrompida retoma do último estado; o arquivo é removido ao terminar.
+ * Sem caminho (ou com operandos negativos) equivale a big_dividir.
+ */
+static BigInt *big_dividir_retomavel(const BigInt *a, const BigInt *b, const char *caminho) {
+    if (!a || !b) return NULL;
+    if (!caminho || a->sinal < 0 || b->sinal < 0 || big_eh_zero(b)) return big_dividir(a, b);
+    BigInt *quociente = big_criar_zero(a->n);
+    if (!quociente) return NULL;
+    quociente->n = a->n;
+    uint64_t hash_a = big_hash(a), hash_b = big_hash(b);
+    BigInt *resto;
+    int i = divisao_carregar_estado(caminho, a, b, hash_a, hash_b, &resto, quociente);
+    if (resto) {
+        printf("Retomando a divisão do checkpoint: %d de %d dígitos prontos.\n", a->n - 1 - i, a->n);
+    } else {
+        resto = big_criar_zero(1);
+    }
+    int passo = a->n / CONSTANTE_BLOCOS + 1;
+    int status = resto ? 0 : -1;
+    while (status == 0 && i >= 0) {
+        int ate = (i - passo + 1 > 0) ? i - passo + 1 : 0;
+        status = divisao_longa_passos(a, b, i, ate, &resto, quociente);
+        i = ate - 1;
+        if (status == 0 && i >= 0) divisao_gravar_estado(caminho, hash_a, hash_b, i, resto, quociente);
+    }
+    big_destruir(resto);
+    if (status != 0) {
+        big_destruir(quociente);
+        return NULL;
+    }
+    remove(caminho);
+    big_normalizar(quociente);
+    return quociente;
+}
+
+/* Tamanho máximo (em dígitos) resolvido diretamente em double pela raiz. */
+#define RAIZ_DIGITOS_BASE 30
+
+/*
+ * Raiz inteira de x > 0 com até RAIZ_DIGITOS_BASE dígitos: estimativa pelo
+ * método de Newton em double, corrigida com aritmética exata.
+ */
+static BigInt *raiz_inteira_base(const BigInt *x) {
+    double v = 0;
+    for (int i = x->n - 1; i >= 0; i--) v = v * 10 + x->digitos[i];
+    double s = 1;
+    while (s * s < v) s *= 2;
+    for (;;) {
+        double proximo = (s + v / s) / 2;
+        if (proximo >= s) break;
+        s = proximo;
+    }
+    BigInt *r = big_criar_int((long long)s);
+    BigInt *um = big_criar_int(1);
+    /* Sobe enquanto (r + 1)^2 <= x e desce enquanto r^2 > x. */
+    while (r && um) {
+        BigInt *seguinte = big_somar(r, um);
+        BigInt *quadrado = seguinte ? big_multiplicar(seguinte, seguinte) : NULL;
+        int sobe = quadrado && big_comparar_abs(quadrado, x) <= 0;
+        big_destruir(quadrado);
+        if (!sobe) {
+            big_destruir(seguinte);
+            break;
+        }
+        big_destruir(r);
+        r = seguinte;
+    }
+    while (r && um) {
+        BigInt *quadrado = big_multiplicar(r, r);
+        int desce = quadrado && big_comparar_abs(quadrado, x) > 0;
+        big_destruir(quadrado);
+        if (!desce) break;
+        BigInt *anterior = big_subtrair(r, um);
+        big_destruir(r);
+        r = anterior;
+    }
+    big_destruir(um);
+    return r;
+}
+
+/*
+ * Raiz inteira de x > 0 (normalizado). A raiz dos dígitos altos de x
+ * (x / 10^2k, k = n/4) já acerta metade dos dígitos; partindo de
+ * (raiz_alta + 1) * 10^k >= raiz(x), um ou dois passos de Newton chegam ao
+ * piso. A divisão de cada passo usa o checkpoint "caminho_div", se houver.
+ */
+static BigInt *raiz_inteira_rec(const BigInt *x, const char *caminho_div) {
+    if (x->n <= RAIZ_DIGITOS_BASE) return raiz_inteira_base(x);
+    int k = x->n / 4;
+    BigInt alto;
+    alto.sinal = 1;
+    alto.n = x->n - 2 * k;
+    alto.digitos = x->digitos + 2 * k;
+    BigInt *raiz_alta = raiz_inteira_rec(&alto, NULL);
+    BigInt *um = big_criar_int(1);
+    BigInt *dois = big_criar_int(2);
+    BigInt *acima = (raiz_alta && um) ? big_somar(raiz_alta, um) : NULL;
+    BigInt *r = acima ? big_deslocar10(acima, k) : NULL;
+    big_destruir(raiz_alta);
+    big_destruir(acima);
+    big_destruir(um);
+    while (r && dois) {
+        BigInt *q = big_dividir_retomavel(x, r, caminho_div);
+        BigInt *soma = q ? big_somar(r, q) : NULL;
+        BigInt *proximo = soma ? big_dividir(soma, dois) : NULL;
+        big_destruir(q);
+        big_destruir(soma);
+        if (!proximo) {
+            big_destruir(r);
+            r = NULL;
+            break;
+        }
+        if (big_comparar_abs(proximo, r) >= 0) {
+            big_destruir(proximo);
+            break;
+        }
+        big_destruir(r);
+        r = proximo;
+        /* Newton por cima nunca passa do piso: r^2 <= x confirma sem outra divisão. */
+        BigInt *quadrado = big_multiplicar(r, r);
+        int pronto = quadrado && big_comparar_abs(quadrado, x) <= 0;
+        big_destruir(quadrado);
+        if (pronto) break;
+    }
+    big_destruir(dois);
+    return r;
+}
+
+/* Raiz quadrada inteira (piso) de x >= 0 pelo método de Newton. */
+BigInt *big_raiz_inteira(const BigInt *x) {
+    if (!x || x->sinal < 0) return NULL;
+    if (big_eh_zero(x)) return big_criar_zero(1);
+    return raiz_inteira_rec(x, NULL);
+}
+
+/*
+ * Raiz do radicando de pi com checkpoint: a raiz pronta fica em
+ * "caminho_raiz" ("RAIZ <hash radicando>", a raiz e "FIM <dígitos> <hash>")
+ * e as divisões de Newton em "caminho_div".
+ */
+static BigInt *constante_raiz(const BigInt *radicando, const char *caminho_raiz,
+                              const char *caminho_div) {
+    uint64_t hash_x = big_hash(radicando);
+    FILE *f = fopen(caminho_raiz, "r");
+    if (f) {
+        char *cabecalho = ler_linha(f);
+        BigInt *raiz = ler_bigint_linha(f);
+        char *rodape = ler_linha(f);
+        fclose(f);
+        unsigned long long lido_x = 0, hash_r = 0;
+        int digitos = 0;
+        char sobra;
+        int ok = cabecalho && sscanf(cabecalho, "RAIZ %llx %c", &lido_x, &sobra) == 1
+                 && lido_x == hash_x && raiz && rodape
+                 && sscanf(rodape, "FIM %d %llx %c", &digitos, &hash_r, &sobra) == 2
+                 && digitos == raiz->n && hash_r == big_hash(raiz);
+        free(cabecalho);
+        free(rodape);
+        if (ok) {
+            printf("Raiz retomada do checkpoint.\n");
+            return raiz;
+        }
+        big_destruir(raiz);
+    }
+    BigInt *raiz = raiz_inteira_rec(radicando, caminho_div);
+    if (!raiz) return NULL;
+    char temporario[1024];
+    arquivo_temporario(temporario, sizeof(temporario), caminho_raiz);
+    f = fopen(temporario, "w");
+    if (f) {
+        fprintf(f, "RAIZ %016llx\n", (unsigned long long)hash_x);
+        big_escrever(f, raiz);
+        fprintf(f, "\nFIM %d %016llx\n", raiz->n, (unsigned long long)big_hash(raiz));
+        arquivo_publicar(f, temporario, caminho_raiz);
+    }
+    return raiz;
+}
+
+/*
+ * Calcula a constante "pi", "e" ou "raiz2" em ponto fixo: o resultado
+ * representa valor * 10^(casas + CONSTANTE_GUARDA), truncado. Se checkpoint
+ * não for NULL, os blocos da série são gravados/retomados desse arquivo, a
+ * raiz de pi de "<checkpoint>.raiz" e a divisão em andamento de
+ * "<checkpoint>.div".
+ */
+BigInt *big_constante(const char *nome, int casas, const char *checkpoint) {
+    if (!nome || casas < 0) return NULL;
+    int m = casas + CONSTANTE_GUARDA;
+    SerieTermo termo;
+    long long termos;
+    if (strcmp(nome, "pi") == 0) {
+        /* Cada termo de Chudnovsky acrescenta ~14,18 dígitos. */
+        termo = serie_termo_pi;
+        termos = (long long)(m / 14.181647462725477) + 2;
+    } else if (strcmp(nome, "e") == 0) {
+        /* Termos até que k! passe de 10^(m+1): mantissa * 10^expoente. */
+        termo = serie_termo_e;
+        double mantissa = 1;
+        long long expoente = 0;
+        termos = 1;
+        while (expoente <= m + 1) {
+            mantissa *= (double)termos;
+            while (mantissa >= 10) {
+                mantissa /= 10;
+                expoente++;
+            }
+            termos++;
+        }
+    } else if (strcmp(nome, "raiz2") == 0) {
+        /* Cada termo acrescenta log10(50) ~ 1,7 dígitos. */
+        termo = serie_termo_raiz2;
+        termos = (long long)(m / 1.6989700043360187) + 2;
+    } else {
+        printf("Erro: constante '%s' desconhecida.\n", nome);
+        return NULL;
+    }
+    char caminho_raiz[960], caminho_div[960];
+    if (checkpoint) {
+        snprintf(caminho_raiz, sizeof(caminho_raiz), "%s.raiz", checkpoint);
+        snprintf(caminho_div, sizeof(caminho_div), "%s.div", checkpoint);
+    }
+    SerieTrinca s;
+    if (constante_serie(nome, termo, termos, checkpoint, &s) != 0) return NULL;
+
+    BigInt *numerador = NULL;
+    BigInt *denominador = NULL;
+    if (termo == serie_termo_pi) {
+        /* pi = 426880 * raiz(10005) * Q / T */
+        BigInt *base = big_criar_int(10005);
+        BigInt *radicando = base ? big_deslocar10(base, 2 * m) : NULL;
+        BigInt *raiz = NULL;
+        if (radicando) {
+            raiz = checkpoint ? constante_raiz(radicando, caminho_raiz, caminho_div)
+                              : big_raiz_inteira(radicando);
+        }
+        BigInt *fator = big_criar_int(426880);
+        BigInt *raiz_fator = (raiz && fator) ? big_multiplicar(raiz, fator) : NULL;
+        numerador = raiz_fator ? big_multiplicar(raiz_fator, s.q) : NULL;
+        denominador = big_copiar(s.t);
+        big_destruir(base);
+        big_destruir(radicando);
+        big_destruir(raiz);
+        big_destruir(fator);
+        big_destruir(raiz_fator);
+    } else if (termo == serie_termo_e) {
+        /* e = T / Q */
+        numerador = big_deslocar10(s.t, m);
+        denominador = big_copiar(s.q);
+    } else {
+        /* raiz(2) = 7 T / (5 Q) */
+        BigInt *sete = big_criar_int(7);
+        BigInt *cinco = big_criar_int(5);
+        BigInt *t7 = sete ? big_multiplicar(s.t, sete) : NULL;
+        numerador = t7 ? big_deslocar10(t7, m) : NULL;
+        denominador = cinco ? big_multiplicar(s.q, cinco) : NULL;
+        big_destruir(sete);
+        big_destruir(cinco);
+        big_destruir(t7);
+    }
+    serie_liberar(&s);
+    BigInt *r = (numerador && denominador)
+                    ? big_dividir_retomavel(numerador, denominador, checkpoint ? caminho_div : NULL)
+                    : NULL;
+    big_destruir(numerador);
+    big_destruir(denominador);
+    return r;
+}
+
+/*
+ * Calcula a constante com "casas" casas decimais e grava em
+ * "<nome>_<casas>.txt", usando "<nome>_<casas>.ckpt" como checkpoint.
+ * O checkpoint (e a raiz gravada ao lado dele) é removido ao final de um
+ * cálculo bem-sucedido.
+ */
+int gravar_constante_txt(const char *nome, int casas) {
+    char caminho[64], checkpoint[64], checkpoint_raiz[80];
+    snprintf(caminho, sizeof(caminho), "%s_%d.txt", nome, casas);
+    snprintf(checkpoint, sizeof(checkpoint), "%s_%d.ckpt", nome, casas);
+    snprintf(checkpoint_raiz, sizeof(checkpoint_raiz), "%s.raiz", checkpoint);
+    BigInt *valor = big_constante(nome, casas, checkpoint);
+    if (!valor) return 0;
+    FILE *f = fopen(caminho, "w");
+    if (!f) {
+        printf("ERRO: nao foi possivel criar '%s'\n", caminho);
+        big_destruir(valor);
+        return 0;
+    }
+    big_escrever_fixo(f, valor, casas + CONSTANTE_GUARDA, casas);
+    fprintf(f, "\n");
+    fclose(f);
+    remove(checkpoint);
+    remove(checkpoint_raiz);
+    /* Valores curtos também são exibidos na tela. */
+    if (casas <= 1000) {
+        printf("%s = ", nome);
+        big_escrever_fixo(stdout, valor, casas + CONSTANTE_GUARDA, casas);
+        printf("\n");
+    }
+    printf("Resultado gravado em '%s'\n", caminho);
+    big_destruir(valor);
+    return 1;
+}
+
+/* -------------------------------------------------------------------------
+ * Geração de BigInt aleatórios (Philox4x32-10, baseado em contador)
+ * ------------------------------------------------------------------------- */
+
+/* Dígitos extraídos de cada chamada do Philox (3 por palavra de 32 bits). */
+#define ALEATORIO_DIGITOS_BLOCO 12
+/* Abaixo deste tamanho o preenchimento roda em uma única thread. */
+#define ALEATORIO_MIN_PARALELO (1 << 20)
+/* Marca no contador para sortear o dígito mais significativo. */
+#define ALEATORIO_CONTADOR_TOPO 0xFFFFFFFFu
+
+/*
+ * Philox4x32-10 (Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3").
+ * A saída depende só de (chave, contador), então qualquer trecho de um número
+ * pode ser gerado de forma independente, em qualquer ordem ou thread.
+ */
+static void philox4x32_10(const uint32_t contador[4], const uint32_t chave[2], uint32_t saida[4]) {
+    uint32_t c0 = contador[0], c1 = contador[1], c2 = contador[2], c3 = contador[3];
+    uint32_t k0 = chave[0], k1 = chave[1];
+    for (int rodada = 0; rodada < 10; rodada++) {
+        uint64_t p0 = (uint64_t)0xD2511F53u * c0;
+        uint64_t p1 = (uint64_t)0xCD9E8D57u * c2;
+        uint32_t n0 = (uint32_t)(p1 >> 32) ^ c1 ^ k0;
+        uint32_t n2 = (uint32_t)(p0 >> 32) ^ c3 ^ k1;
+        c1 = (uint32_t)p1;
+        c3 = (uint32_t)p0;
+        c0 = n0;
+        c2 = n2;
+        k0 += 0x9E3779B9u;
+        k1 += 0xBB67AE85u;
+    }
+    saida[0] = c0;
+    saida[1] = c1;
+    saida[2] = c2;
+    saida[3] = c3;
+}
+
+/* Gera 4 palavras para o bloco "bloco" do fluxo "fluxo" com a semente dada. */
+static void aleatorio_bloco(uint64_t semente, uint64_t fluxo, uint32_t bloco, uint32_t marca,
+                            uint32_t saida[4]) {
+    uint32_t chave[2] = { (uint32_t)semente, (uint32_t)(semente >> 32) };
+    uint32_t contador[4] = { bloco, marca, (uint32_t)fluxo, (uint32_t)(fluxo >> 32) };
+    philox4x32_10(contador, chave, saida);
+}
+
+/*
+ * Preenche digitos[ini..fim) (posições do número, 0 = menos significativo).
+ * Cada palavra de 32 bits vira 3 dígitos via (w * 1000) >> 32.
+ */
+static void aleatorio_preencher(uint64_t semente, uint64_t fluxo, int *digitos, int ini, int fim) {
+    uint32_t palavras[4];
+    int i = ini;
+    while (i < fim) {
+        uint32_t bloco = (uint32_t)(i / ALEATORIO_DIGITOS_BLOCO);
+        aleatorio_bloco(semente, fluxo, bloco, 0, palavras);
+        int base = (int)bloco * ALEATORIO_DIGITOS_BLOCO;
+        for (int w = 0; w < 4; w++) {
+            uint32_t tres = (uint32_t)(((uint64_t)palavras[w] * 1000) >> 32);
+            int valores[3] = { (int)(tres % 10), (int)(tres / 10 % 10), (int)(tres / 100) };
+            for (int d = 0; d < 3; d++) {
+                int pos = base + w * 3 + d;
+                if (pos >= i && pos < fim) digitos[pos] = valores[d];
+            }
+        }
+        i = base + ALEATORIO_DIGITOS_BLOCO;
+    }
+}
+
+/* Trecho de um número aleatório preenchido por uma thread. */
+typedef struct {
+    uint64_t semente;
+    uint64_t fluxo;
+    int *digitos;
+    int ini;
+    int fim;
+} TarefaAleatorio;
+
+static void *aleatorio_thread(void *arg) {
+    TarefaAleatorio *t = (TarefaAleatorio *)arg;
+    aleatorio_preencher(t->semente, t->fluxo, t->digitos, t->ini, t->fim);
+    return NULL;
+}
+
+/*
+ * Gera um BigInt não negativo com exatamente "qtd_digitos" dígitos (o mais
+ * significativo nunca é zero). O resultado depende apenas de (semente, fluxo),
+ * independentemente do número de threads usadas; use fluxos diferentes para
+ * sequências independentes com a mesma semente.
+ */
+BigInt *big_aleatorio(uint64_t semente, uint64_t fluxo, int qtd_digitos) {
+    if (qtd_digitos < 1) qtd_digitos = 1;
+    BigInt *x = big_criar_zero(qtd_digitos);
+    if (!x) return NULL;
+    x->n = qtd_digitos;
+    int threads = 1;
+    if (qtd_digitos >= 2 * ALEATORIO_MIN_PARALELO) {
+        threads = calc_num_nucleos();
+        if (threads > qtd_digitos / ALEATORIO_MIN_PARALELO) {
+            threads = qtd_digitos / ALEATORIO_MIN_PARALELO;
+        }
+    }
+    TarefaAleatorio tarefas[64];
+    if (threads > 64) threads = 64;
+    for (int t = 0; t < threads; t++) {
+        TarefaAleatorio tarefa = { semente, fluxo, x->digitos,
+                                   (int)((long long)qtd_digitos * t / threads),
+                                   (int)((long long)qtd_digitos * (t + 1) / threads) };
+        tarefas[t] = tarefa;
+    }
+#ifndef CALC_SEM_THREADS
+    pthread_t ids[64];
+    int criadas = 0;
+    for (int t = 1; t < threads; t++, criadas++) {
+        if (pthread_create(&ids[t], NULL, aleatorio_thread, &tarefas[t]) != 0) break;
+    }
+    aleatorio_thread(&tarefas[0]);
+    for (int t = 1; t <= criadas; t++) {
+        pthread_join(ids[t], NULL);
+    }
+    /* Trechos sem thread (falha ao criar) são preenchidos aqui. */
+    for (int t = criadas + 1; t < threads; t++) {
+        aleatorio_thread(&tarefas[t]);
+    }
+#else
+    for (int t = 0; t < threads; t++) {
+        aleatorio_thread(&tarefas[t]);
+    }
+#endif
+    /* Dígito mais significativo em 1..9, sorteado de um contador reservado. */
+    uint32_t palavras[4];
+    aleatorio_bloco(semente, fluxo, 0, ALEATORIO_CONTADOR_TOPO, palavras);
+    x->digitos[qtd_digitos - 1] = 1 + (int)(((uint64_t)palavras[0] * 9) >> 32);
+    return x;
+}
+
+/*
+ * Grava "qtd_numeros" BigInt aleatórios de "qtd_digitos" dígitos em "caminho".
+ * O número j usa o fluxo j, então qualquer número do arquivo pode ser
+ * regenerado isoladamente com big_aleatorio(semente, j, qtd_digitos).
+ * Formato texto: um número por linha.
+ * Formato binário: "BIGR", uint32 quantidade e, para cada número, uint32 n
+ * seguido de n bytes (dígitos 0-9, do menos para o mais significativo).
+ * Inteiros em little-endian. Retorna 1 se sucesso, 0 se erro.
+ */
+int gravar_aleatorios(const char *caminho, uint64_t semente, int qtd_numeros,
+                      int qtd_digitos, int binario) {
+    FILE *f = fopen(caminho, binario ? "wb" : "w");
+    if (!f) {
+        printf("ERRO: nao foi possivel criar '%s'\n", caminho);
+        return 0;
+    }
+    if (qtd_digitos < 1) qtd_digitos = 1;
+    unsigned char *bytes = binario ? (unsigned char *)malloc(qtd_digitos) : NULL;
+    int ok = !binario || bytes;
+    if (ok && binario) {
+        unsigned char cabecalho[8] = { 'B', 'I', 'G', 'R',
+                                       (unsigned char)qtd_numeros, (unsigned char)(qtd_numeros >> 8),
+                                       (unsigned char)(qtd_numeros >> 16), (unsigned char)(qtd_numeros >> 24) };
+        ok = fwrite(cabecalho, 1, sizeof(cabecalho), f) == sizeof(cabecalho);
+    }
+    for (int j = 0; j < qtd_numeros && ok; j++) {
+        BigInt *x = big_aleatorio(semente, (uint64_t)j, qtd_digitos);
+        if (!x) {
+            ok = 0;
+            break;
+        }
+        if (binario) {
+            unsigned char n[4] = { (unsigned char)x->n, (unsigned char)(x->n >> 8),
+                                   (unsigned char)(x->n >> 16), (unsigned char)(x->n >> 24) };
+            for (int i = 0; i < x->n; i++) {
+                bytes[i] = (unsigned char)x->digitos[i];
+            }
+            ok = fwrite(n, 1, 4, f) == 4 && fwrite(bytes, 1, x->n, f) == (size_t)x->n;
+        } else {
+            big_escrever(f, x);
+            ok = fputc('\n', f) != EOF;
+        }
+        big_destruir(x);
+    }
+    free(bytes);
+    if (fclose(f) != 0) ok = 0;
+    if (!ok) {
+        printf("ERRO: falha ao gravar '%s'\n", caminho);
+        return 0;
+    }
+    printf("%d número(s) gravado(s) em '%s'\n", qtd_numeros, caminho);
+    return 1;
+}
+
+/* -------------------------------------------------------------------------
+ * Autoteste: verificação diferencial e por propriedades dos núcleos
+ * ------------------------------------------------------------------------- */
+
+/* Tamanho máximo (em dígitos) dos operandos sorteados pelo autoteste. */
+#define AUTOTESTE_MAX_DIGITOS 300
+/* Acima deste tamanho o MDC é verificado só pela divisibilidade. */
+#define AUTOTESTE_MAX_DIGITOS_MDC 60
+/* Marca no contador do Philox para os sorteios do autoteste. */
+#define AUTOTESTE_CONTADOR 0xFFFFFFFEu
+
+/* Compara valores (sinal e módulo) de dois BigInt normalizados. */
+static int big_iguais(const BigInt *a, const BigInt *b) {
+    if (!a || !b) return 0;
+    int sinal_a = big_eh_zero(a) ? 1 : a->sinal;
+    int sinal_b = big_eh_zero(b) ? 1 : b->sinal;
+    return sinal_a == sinal_b && big_comparar_abs(a, b) == 0;
+}
+
+/* Referência para a multiplicação: multiplica-acumula no BigAcumulador. */
+static BigInt *ref_multiplicar(const BigInt *a, const BigInt *b) {
+    BigAcumulador *acc = big_acum_criar(a->n + b->n);
+    BigInt *r = (acc && big_acum_mac(acc, a, b) == 0) ? big_acum_valor(acc) : NULL;
+    big_acum_destruir(acc);
+    return r;
+}
+
+/* Referência para a soma com sinal: duas parcelas no BigAcumulador. */
+static BigInt *ref_somar(const BigInt *a, const BigInt *b) {
+    BigAcumulador *acc = big_acum_criar(a->n + b->n);
+    BigInt *r = (acc && big_acum_somar(acc, a) == 0 && big_acum_somar(acc, b) == 0)
+                    ? big_acum_valor(acc) : NULL;
+    big_acum_destruir(acc);
+    return r;
+}
+
+/* Mostra a verificação que falhou e os operandos envolvidos. */
+static int autoteste_falha(const char *verificacao, const BigInt *a, const BigInt *b) {
+    printf("FALHA: %s\n  a = ", verificacao);
+    big_imprimir(a);
+    printf("\n  b = ");
+    big_imprimir(b);
+    printf("\n");
+    return 0;
+}
+
+/* Verifica q * b + r == a, |r| < |b| e o sinal do resto. */
+static int autoteste_divisao(const BigInt *a, const BigInt *b) {
+    BigInt *r = NULL;
+    BigInt *q = big_dividir_mod(a, b, &r);
+    if (!q || !r) {
+        big_destruir(q);
+        big_destruir(r);
+        return autoteste_falha("big_dividir_mod retornou NULL", a, b);
+    }
+    BigAcumulador *acc = big_acum_criar(a->n + 1);
+    BigInt *recomposto = (acc && big_acum_mac(acc, q, b) == 0 && big_acum_somar(acc, r) == 0)
+                             ? big_acum_valor(acc) : NULL;
+    big_acum_destruir(acc);
+    int ok = 1;
+    if (!big_iguais(recomposto, a)) {
+        ok = autoteste_falha("q * b + r != a", a, b);
+    } else if (big_comparar_abs(r, b) >= 0) {
+        ok = autoteste_falha("|r| >= |b|", a, b);
+    } else if (!big_eh_zero(r) && r->sinal != a->sinal) {
+        ok = autoteste_falha("sinal do resto difere do dividendo", a, b);
+    }
+    big_destruir(recomposto);
+    big_destruir(q);
+    big_destruir(r);
+    return ok;
+}
+
+/* Verifica que o MDC divide a e b e, para operandos curtos, que é o maior. */
+static int autoteste_mdc(const BigInt *a, const BigInt *b) {
+    BigInt *g = big_mdc(a, b);
+    if (!g) return autoteste_falha("big_mdc retornou NULL", a, b);
+    int ok = 1;
+    if (big_eh_zero(g)) {
+        if (!big_eh_zero(a) || !big_eh_zero(b)) ok = autoteste_falha("mdc == 0", a, b);
+        big_destruir(g);
+        return ok;
+    }
+    BigInt *ra = big_mod(a, g);
+    BigInt *rb = big_mod(b, g);
+    if (!ra || !rb || !big_eh_zero(ra) || !big_eh_zero(rb)) {
+        ok = autoteste_falha("mdc não divide os operandos", a, b);
+    } else if (a->n <= AUTOTESTE_MAX_DIGITOS_MDC && b->n <= AUTOTESTE_MAX_DIGITOS_MDC) {
+        BigInt *qa = big_dividir(a, g);
+        BigInt *qb = big_dividir(b, g);
+        BigInt *um = (qa && qb) ? big_mdc(qa, qb) : NULL;
+        if (!um || !(um->n == 1 && um->digitos[0] == 1)) {
+            ok = autoteste_falha("mdc(a/g, b/g) != 1", a, b);
+        }
+        big_destruir(qa);
+        big_destruir(qb);
+        big_destruir(um);
+    }
+    big_destruir(ra);
+    big_destruir(rb);
+    big_destruir(g);
+    return ok;
+}
+
+/*
+ * Executa todas as verificações para o par (a, b). Retorna 1 se todas
+ * passaram.
+ */
+int autoteste_verificar(const BigInt *a, const BigInt *b) {
+    int ok = 1;
+
+    /* Soma e subtração com sinal contra o acumulador. */
+    BigInt *soma = big_somar(a, b);
+    BigInt *soma_ref = ref_somar(a, b);
+    if (!big_iguais(soma, soma_ref)) ok = autoteste_falha("big_somar != referência", a, b);
+    BigInt *dif = big_subtrair(a, b);
+    BigAcumulador *acc_dif = big_acum_criar(a->n + b->n);
+    BigInt *dif_ref = (acc_dif && big_acum_somar(acc_dif, a) == 0 &&
+                       big_acum_subtrair(acc_dif, b) == 0) ? big_acum_valor(acc_dif) : NULL;
+    big_acum_destruir(acc_dif);
+    if (!big_iguais(dif, dif_ref)) ok = autoteste_falha("big_subtrair != referência", a, b);
+    big_destruir(dif);
+    big_destruir(dif_ref);
+
+    /* Árvore de somas contra a soma direta. */
+    const BigInt *parcelas[3] = { a, b, a };
+    BigInt *arvore_soma = big_soma_lista((BigInt *const *)parcelas, 3);
+    BigInt *soma_aba = soma ? big_somar(soma, a) : NULL;
+    if (!big_iguais(arvore_soma, soma_aba)) ok = autoteste_falha("big_soma_lista != a + b + a", a, b);
+    big_destruir(arvore_soma);
+    big_destruir(soma_aba);
+    big_destruir(soma);
+    big_destruir(soma_ref);
+
+    /* Multiplicação contra a referência e comutatividade. */
+    BigInt *ab = big_multiplicar(a, b);
+    BigInt *ba = big_multiplicar(b, a);
+    BigInt *ab_ref = ref_multiplicar(a, b);
+    if (!big_iguais(ab, ab_ref)) ok = autoteste_falha("big_multiplicar != referência", a, b);
+    if (!big_iguais(ab, ba)) ok = autoteste_falha("a * b != b * a", a, b);
+
+    /* Árvore de produtos contra a multiplicação direta. */
+    const BigInt *lista[3] = { a, b, a };
+    BigInt *arvore = big_produto_lista((BigInt *const *)lista, 3);
+    BigInt *aba = ab ? big_multiplicar(ab, a) : NULL;
+    if (!big_iguais(arvore, aba)) ok = autoteste_falha("big_produto_lista != a * b * a", a, b);
+    big_destruir(arvore);
+    big_destruir(aba);
+
+    /* Acumulador: a - b + b == a e a*b - a*b == 0. */
+    BigAcumulador *acc = big_acum_criar(1);
+    if (acc) {
+        big_acum_somar(acc, a);
+        big_acum_subtrair(acc, b);
+        big_acum_somar(acc, b);
+        BigInt *volta = big_acum_valor(acc);
+        if (!big_iguais(volta, a)) ok = autoteste_falha("acumulador: a - b + b != a", a, b);
+        big_destruir(volta);
+        big_acum_subtrair(acc, a);
+        big_acum_mac(acc, a, b);
+        if (ab) big_acum_subtrair(acc, ab);
+        BigInt *zero = big_acum_valor(acc);
+        if (!zero || !big_eh_zero(zero)) ok = autoteste_falha("acumulador: a*b - a*b != 0", a, b);
+        big_destruir(zero);
+    }
+    big_acum_destruir(acc);
+    big_destruir(ab);
+    big_destruir(ba);
+    big_destruir(ab_ref);
+
+    /* Divisão e MDC (divisor zero é rejeitado pela própria função). */
+    if (!big_eh_zero(b)) ok &= autoteste_divisao(a, b);
+    if (!big_eh_zero(a)) ok &= autoteste_divisao(b, a);
+    ok &= autoteste_mdc(a, b);
+    return ok;
+}
+
+/*
+ * Sorteia o operando "lado" do caso "caso": números aleatórios de tamanho
+ * variado e casos adversos (zero, um, 99...9, 10^k, 10^k + 1, dígito repetido).
+ */
+static BigInt *autoteste_operando(uint64_t semente, uint32_t caso, uint32_t lado) {
+    uint32_t w[4];
+    aleatorio_bloco(semente, ((uint64_t)lado << 32) | caso, 0, AUTOTESTE_CONTADOR, w);
+    /* Tamanhos pequenos são mais frequentes: máximo sorteado em escala 10^k. */
+    int limites[3] = { 9, 40, AUTOTESTE_MAX_DIGITOS };
+    int n = 1 + (int)(w[1] % (uint32_t)limites[w[2] % 3]);
+    BigInt *x = big_aleatorio(semente, ((uint64_t)lado << 32) | caso, n);
+    if (!x) return NULL;
+    switch (w[0] % 8) {
+        case 0: /* zero */
+            x->n = 1;
+            x->digitos[0] = 0;
+            break;
+        case 1: /* um */
+            x->n = 1;
+            x->digitos[0] = 1;
+            break;
+        case 2: /* 99...9 */
+            for (int i = 0; i < x->n; i++) x->digitos[i] = 9;
+            break;
+        case 3: /* 10^k e 10^k + 1 */
+            for (int i = 0; i < x->n; i++) x->digitos[i] = 0;
+            x->digitos[x->n - 1] = 1;
+            x->digitos[0] += (int)(w[3] & 1);
+            break;
+        case 4: /* dígito repetido */
+            for (int i = 0; i < x->n; i++) x->digitos[i] = x->digitos[x->n - 1];
+            break;
+        default: /* aleatório */
+            break;
+    }
+    x->sinal = (w[3] & 2) ? -1 : 1;
+    big_normalizar(x);
+    return x;
+}
+
+/*
+ * Roda casos sorteados até esgotar "segundos" (tempo de CPU) ou achar uma
+ * falha. Pensado para rodar sob sanitizers (-fsanitize=address,undefined).
+ * Retorna 1 se todos os casos passaram.
+ */
+int big_autoteste(double segundos, uint64_t semente) {
+    clock_t inicio = clock();
+    clock_t limite = inicio + (clock_t)(segundos * CLOCKS_PER_SEC);
+    uint32_t casos = 0;
+    int ok = 1;
+    do {
+        BigInt *a = autoteste_operando(semente, casos, 0);
+        BigInt *b = autoteste_operando(semente, casos, 1);
+        if (!a || !b) {
+            big_destruir(a);
+            big_destruir(b);
+            printf("ERRO: sem memória no autoteste\n");
+            return 0;
+        }
+        ok = autoteste_verificar(a, b);
+        big_destruir(a);
+        big_destruir(b);
+        casos++;
+    } while (ok && clock() < limite);
+    double decorrido = (double)(clock() - inicio) / CLOCKS_PER_SEC;
+    printf("Autoteste (seed %llu): %u caso(s) em %.2f s (%.0f casos/s) - %s\n",
+           (unsigned long long)semente, casos, decorrido,
+           decorrido > 0 ? casos / decorrido : 0.0, ok ? "OK" : "FALHOU");
+    return ok;
+}
+
+/*
+ * Converte bytes arbitrários em um par de operandos e verifica o par.
+ * byte 0: sinais; byte 1: ponto de divisão entre a e b; restante: dígitos
+ * (byte % 10, do mais para o menos significativo).
+ */
+int autoteste_bytes(const uint8_t *dados, size_t tamanho) {
+    if (tamanho < 2) return 1;
+    if (tamanho > 4096) tamanho = 4096;
+    size_t resto = tamanho - 2;
+    size_t corte = (resto * dados[1]) / 256;
+    char *texto = (char *)malloc(resto + 4);
+    if (!texto) return 1;
+    BigInt *x[2];
+    size_t ini[2] = { 2, 2 + corte };
+    size_t fim[2] = { 2 + corte, tamanho };
+    for (int k = 0; k < 2; k++) {
+        size_t len = 0;
+        texto[len++] = (dados[0] >> k) & 1 ? '-' : '+';
+        for (size_t i = ini[k]; i < fim[k]; i++) {
+            texto[len++] = (char)('0' + dados[i] % 10);
+        }
+        texto[len] = '\0';
+        x[k] = big_criar(texto);
+    }
+    free(texto);
+    int ok = (x[0] && x[1]) ? autoteste_verificar(x[0], x[1]) : 1;
+    big_destruir(x[0]);
+    big_destruir(x[1]);
+    return ok;
+}
+
+/* Verifica um caso lido da entrada padrão (modo de execução do AFL). */
+int autoteste_entrada_padrao(void) {
+    uint8_t dados[4096];
+    size_t tamanho = fread(dados, 1, sizeof(dados), stdin);
+    if (autoteste_bytes(dados, tamanho)) return 1;
+    abort();
+}
+
+#ifdef CALC_FUZZ
+/*
+ * Alvo para libFuzzer / AFL++:
+ *   clang -g -O1 -fsanitize=fuzzer,address,undefined -DCALC_FUZZ src/calculadora.c
+ */
+int LLVMFuzzerTestOneInput(const uint8_t *dados, size_t tamanho) {
+    if (!autoteste_bytes(dados, tamanho)) abort();
+    return 0;
+}
+#endif
+
+/* -------------------------------------------------------------------------
+ * Funções da calculadora simples (versão com int / long long)
+ * ------------------------------------------------------------------------- */
+void somar(int a, int b) {
+    printf("A soma é: %d\n", a + b);
+}
+void subtrair(int a, int b) {
+    printf("A subtração é: %d\n", a - b);
+}
+void multiplicar(int a, int b) {
+    printf("A multiplicação é: %d\n", a * b);
+}
+void dividir(int a, int b) {
+    if (b == 0) {
+        printf("Erro: divisão por zero não é permitida.\n");
+        return;
+    }
+    printf("A divisão é: %d\n", a / b);
+}
+
+/* Gera um número pseudoaleatório com quantidade de dígitos controlada por n */
+void seed(int seed_value, int n) {
+    BigInt *x = big_aleatorio((uint64_t)(unsigned int)seed_value, 0, n);
+    printf("Número gerado: ");
+    big_imprimir(x);
+    printf("\n");
+    big_destruir(x);
+}
+
+/*
+ * Soma dígito por dígito de dois inteiros comuns, simulando soma de "números grandes".
+ * Ainda está usando int/long long, mas a lógica serve como base para BigInt.
+ */
+void soma_por_digitos(int a, int b) {
+    long long a_long = (long long)a;
+    long long b_long = (long long)b;
+    int resultado[200];
+    int i = 0;
+    int sobra = 0;
+    while (a_long > 0 || b_long > 0 || sobra > 0) {
+        int d1 = a_long % 10;
+        int d2 = b_long % 10;
+        int soma = d1 + d2 + sobra;
+        resultado[i++] = soma % 10;
+        sobra = soma / 10;
+        a_long /= 10;
+        b_long /= 10;
+    }
+    printf("Resultado: ");
+    for (int j = i - 1; j >= 0; j--) {
+        printf("%d", resultado[j]);
+    }
+    printf("\n");
+}
+
+/*Implementa um menu para operações int e long long*/
+void menu_inteiros_entrada_usuario() {
+    int num_usuario;
+    int a, b;
+    int continuar = 1;
+    while (continuar) {
+        printf("\n============================================================\n");
+        printf(" CALCULADORA INT \n");
+        printf("============================================================\n");
+        printf(" [1] ➜ Soma\n");
+        printf(" [2] ➜ Subtração\n");
+        printf(" [3] ➜ Multiplicação\n");
+        printf(" [4] ➜ Divisão\n");
+        printf(" [5] ➜ Geração de número aleatório com seed\n");
+        printf(" [6] ➜ Soma dígito por dígito\n");
+        printf("------------------------------------------------------------\n");
+        printf(" [7] ➜ Voltar ao menu principal\n");
+        printf("============================================================\n");
+        printf("Escolha uma opção: ");
+        if (scanf("%d", &num_usuario) != 1) {
+            printf("Entrada inválida.\n");
+            int c;
+            while ((c = getchar()) != '\n' && c != EOF) {}
+            continue;
+        }
+        switch (num_usuario) {
+            case 1:
+                printf("Digite dois números: ");
+                scanf("%d %d", &a, &b);
+                somar(a, b);
+                break;
+            case 2:
+                printf("Digite dois números: ");
+                scanf("%d %d", &a, &b);
+                subtrair(a, b);
+                break;
+            case 3:
+                printf("Digite dois números: ");
+                scanf("%d %d", &a, &b);
+                multiplicar(a, b);
+                break;
+            case 4:
+                printf("Digite dois números: ");
+                scanf("%d %d", &a, &b);
+                dividir(a, b);
+                break;
+            case 5:
+                printf("Digite o seed e a quantidade de dígitos: ");
+                scanf("%d %d", &a, &b);
+                seed(a, b);
+                break;
+            case 6:
+                printf("Digite dois números: ");
+                scanf("%d %d", &a, &b);
+                soma_por_digitos(a, b);
+                break;
+            case 7:
+                return;
+            default:
+                printf("Opção inválida.\n");
+                break;
+        }
+    }
+}
+
+/*Implementa um menu para operações com bigint*/
+void menu_bigint_entrada_usuario() {
+    int opc = 1;
+    char A[1024], B[1024];
+    while (opc) {
     printf("\n============================================================\n");
     printf(" CALCULADORA BIGINT \n");
     printf("============================================================\n");
@@ -578,15 +2438,70 @@ void menu_bigint_entrada_usuario() {
     printf("------------------------------------------------------------\n");
     printf(" [6] ➜ MDC (máximo divisor comum)\n");
     printf("------------------------------------------------------------\n");
-    printf(" [7] ➜ Voltar ao menu principal\n");
+    printf(" [7] ➜ Fatorial (n!)\n");
+    printf(" [8] ➜ Binomial C(n, k)\n");
+    printf(" [9] ➜ Primorial (n#)\n");
+    printf(" [10] ➜ Constantes (pi, e, raiz de 2)\n");
+    printf(" [11] ➜ Gerar números aleatórios em arquivo\n");
+    printf("------------------------------------------------------------\n");
+    printf(" [12] ➜ Voltar ao menu principal\n");
     printf("============================================================\n");
     printf("Escolha uma opção: ");
         scanf("%d", &opc);
-        if (opc == 7) break;
-        if (opc < 1 || opc > 7) {
+        if (opc == 12) break;
+        if (opc < 1 || opc > 12) {
             printf("Opção inválida.\n");
             continue;
         }
+        if (opc == 11) {
+            unsigned long long semente = 0;
+            int qtd = 0, digitos = 0, formato = 0;
+            printf("Digite a seed, a quantidade de números e de dígitos: ");
+            scanf("%llu %d %d", &semente, &qtd, &digitos);
+            printf("Formato [1] texto (aleatorios.txt)  [2] binário (aleatorios.bin): ");
+            scanf("%d", &formato);
+            if (qtd < 0 || (formato != 1 && formato != 2)) {
+                printf("Opção inválida.\n");
+                continue;
+            }
+            gravar_aleatorios(formato == 2 ? "aleatorios.bin" : "aleatorios.txt",
+                              (uint64_t)semente, qtd, digitos, formato == 2);
+            continue;
+        }
+        if (opc == 10) {
+            const char *nomes[] = { "pi", "e", "raiz2" };
+            int constante = 0, casas = 0;
+            printf("Constante [1] pi  [2] e  [3] raiz de 2: ");
+            scanf("%d", &constante);
+            printf("Quantidade de casas decimais: ");
+            scanf("%d", &casas);
+            if (constante < 1 || constante > 3 || casas < 0) {
+                printf("Opção inválida.\n");
+                continue;
+            }
+            gravar_constante_txt(nomes[constante - 1], casas);
+            continue;
+        }
+        if (opc >= 7 && opc <= 9) {
+            int n = 0, k = 0;
+            BigInt *r = NULL;
+            if (opc == 8) {
+                printf("Digite n e k: ");
+                scanf("%d %d", &n, &k);
+                r = big_binomial(n, k);
+            } else {
+                printf("Digite n: ");
+                scanf("%d", &n);
+                r = (opc == 7) ? big_fatorial(n) : big_primorial(n);
+            }
+            if (r) {
+                printf("Resultado: ");
+                big_imprimir(r);
+                printf("\n");
+            }
+            big_destruir(r);
+            continue;
+        }
         printf("Digite o primeiro número: ");
         scanf("%s", A);
         printf("Digite o segundo número: ");
@@ -642,137 +2557,1430 @@ void menu_bigint_entrada_usuario() {
             default:
                 printf("Opção inválida.\n");
         }
-        big_destruir(a);
-        big_destruir(b);
-        big_destruir(r);
+        big_destruir(a);
+        big_destruir(b);
+        big_destruir(r);
+    }
+}
+
+/* ==============================================================
+                CACHE DE RESULTADOS
+   ============================================================== */
+
+/* Limite padrão de memória do cache (bytes). */
+#define CACHE_LIMITE_PADRAO (64u * 1024u * 1024u)
+/* Baldes iniciais da tabela hash (potência de 2). */
+#define CACHE_BALDES_INICIAIS 1024
+
+/*
+ * Avalia "a op b" para as operações do modo arquivo e do servidor:
+ * + - * / % e 'm' (MDC). Retorna NULL em erro ou operação desconhecida.
+ * O resultado sai normalizado (sem zeros à esquerda).
+ */
+BigInt *big_avaliar(char op, const BigInt *a, const BigInt *b) {
+    BigInt *r;
+    switch (op) {
+        case '+': r = big_somar(a, b);       break;
+        case '-': r = big_subtrair(a, b);    break;
+        case '*': r = big_multiplicar(a, b); break;
+        case '/': r = big_dividir(a, b);     break;
+        case '%': r = big_mod(a, b);         break;
+        case 'm': r = big_mdc(a, b);         break;
+        default:
+            printf("Operacao '%c' nao suportada!\n", op);
+            return NULL;
+    }
+    big_normalizar(r);
+    return r;
+}
+
+/*
+ * Entrada do cache. Os operandos são guardados junto com o resultado para
+ * que uma colisão de hash nunca devolva um resultado errado.
+ */
+typedef struct EntradaCache {
+    uint64_t chave;
+    char op;
+    BigInt *a;
+    BigInt *b;
+    BigInt *resultado;
+    size_t bytes;
+    struct EntradaCache *proxima_balde;
+    struct EntradaCache *anterior;  /* mais recente */
+    struct EntradaCache *seguinte;  /* menos recente */
+} EntradaCache;
+
+/*
+ * Cache LRU em memória, com camada opcional em disco: cada resultado também
+ * é gravado em "<diretorio>/<chave>.cache" e consultado quando falta na memória.
+ */
+typedef struct {
+    EntradaCache **baldes;
+    int qtd_baldes;
+    int qtd_entradas;
+    size_t bytes;
+    size_t limite_bytes;
+    EntradaCache *mais_recente;
+    EntradaCache *menos_recente;
+    char diretorio[512];
+    unsigned long long acertos;
+    unsigned long long faltas;
+} CacheResultados;
+
+static CacheResultados cache = { NULL, 0, 0, 0, CACHE_LIMITE_PADRAO, NULL, NULL, "", 0, 0 };
+
+#ifndef CALC_SEM_THREADS
+static pthread_mutex_t cache_trava = PTHREAD_MUTEX_INITIALIZER;
+#define CACHE_TRAVAR() pthread_mutex_lock(&cache_trava)
+#define CACHE_DESTRAVAR() pthread_mutex_unlock(&cache_trava)
+#else
+#define CACHE_TRAVAR() ((void)0)
+#define CACHE_DESTRAVAR() ((void)0)
+#endif
+
+/* Só operações mais caras que copiar o resultado valem a pena guardar. */
+static int cache_operacao_cara(char op) {
+    return op == '*' || op == '/' || op == '%' || op == 'm';
+}
+
+static uint64_t cache_chave(char op, const BigInt *a, const BigInt *b) {
+    uint64_t h = big_hash(a);
+    h ^= big_hash(b) + 0x9E3779B97F4A7C15ULL + (h << 6) + (h >> 2);
+    return (h ^ (uint64_t)(unsigned char)op) * 1099511628211ULL;
+}
+
+static int cache_confere(const EntradaCache *e, char op, const BigInt *a, const BigInt *b) {
+    return e->op == op && big_iguais(e->a, a) && big_iguais(e->b, b);
+}
+
+/* Remove a entrada da lista LRU (não libera). */
+static void cache_desligar(EntradaCache *e) {
+    if (e->anterior) e->anterior->seguinte = e->seguinte;
+    else cache.mais_recente = e->seguinte;
+    if (e->seguinte) e->seguinte->anterior = e->anterior;
+    else cache.menos_recente = e->anterior;
+    e->anterior = e->seguinte = NULL;
+}
+
+/* Coloca a entrada no início da lista LRU. */
+static void cache_ligar_inicio(EntradaCache *e) {
+    e->anterior = NULL;
+    e->seguinte = cache.mais_recente;
+    if (cache.mais_recente) cache.mais_recente->anterior = e;
+    cache.mais_recente = e;
+    if (!cache.menos_recente) cache.menos_recente = e;
+}
+
+static void cache_liberar_entrada(EntradaCache *e) {
+    big_destruir(e->a);
+    big_destruir(e->b);
+    big_destruir(e->resultado);
+    free(e);
+}
+
+/* Remove a entrada menos usada recentemente. */
+static void cache_descartar_lru(void) {
+    EntradaCache *e = cache.menos_recente;
+    if (!e) return;
+    cache_desligar(e);
+    EntradaCache **p = &cache.baldes[e->chave & (uint64_t)(cache.qtd_baldes - 1)];
+    while (*p && *p != e) p = &(*p)->proxima_balde;
+    if (*p) *p = e->proxima_balde;
+    cache.bytes -= e->bytes;
+    cache.qtd_entradas--;
+    cache_liberar_entrada(e);
+}
+
+/* Dobra a tabela hash quando há mais entradas que baldes. */
+static void cache_crescer(void) {
+    int novos = cache.qtd_baldes ? cache.qtd_baldes * 2 : CACHE_BALDES_INICIAIS;
+    EntradaCache **baldes = (EntradaCache **)calloc(novos, sizeof(EntradaCache *));
+    if (!baldes) return;
+    for (int i = 0; i < cache.qtd_baldes; i++) {
+        EntradaCache *e = cache.baldes[i];
+        while (e) {
+            EntradaCache *prox = e->proxima_balde;
+            EntradaCache **balde = &baldes[e->chave & (uint64_t)(novos - 1)];
+            e->proxima_balde = *balde;
+            *balde = e;
+            e = prox;
+        }
+    }
+    free(cache.baldes);
+    cache.baldes = baldes;
+    cache.qtd_baldes = novos;
+}
+
+/* Procura na memória; em caso de acerto a entrada vira a mais recente. */
+static EntradaCache *cache_buscar(uint64_t chave, char op, const BigInt *a, const BigInt *b) {
+    if (!cache.baldes) return NULL;
+    EntradaCache *e = cache.baldes[chave & (uint64_t)(cache.qtd_baldes - 1)];
+    while (e && !(e->chave == chave && cache_confere(e, op, a, b))) {
+        e = e->proxima_balde;
+    }
+    if (e) {
+        cache_desligar(e);
+        cache_ligar_inicio(e);
+    }
+    return e;
+}
+
+/* Insere uma cópia de (op, a, b, resultado), respeitando o limite de memória. */
+static void cache_inserir(uint64_t chave, char op, const BigInt *a, const BigInt *b,
+                          const BigInt *resultado) {
+    size_t bytes = sizeof(EntradaCache) + 3 * sizeof(BigInt)
+                   + (size_t)(a->n + b->n + resultado->n) * sizeof(int);
+    if (bytes > cache.limite_bytes) return;
+    if (cache.qtd_entradas >= cache.qtd_baldes) cache_crescer();
+    if (!cache.baldes) return;
+    EntradaCache *e = (EntradaCache *)calloc(1, sizeof(EntradaCache));
+    if (!e) return;
+    e->chave = chave;
+    e->op = op;
+    e->a = big_copiar(a);
+    e->b = big_copiar(b);
+    e->resultado = big_copiar(resultado);
+    e->bytes = bytes;
+    if (!e->a || !e->b || !e->resultado) {
+        cache_liberar_entrada(e);
+        return;
+    }
+    while (cache.mais_recente && cache.bytes + bytes > cache.limite_bytes) {
+        cache_descartar_lru();
+    }
+    EntradaCache **balde = &cache.baldes[chave & (uint64_t)(cache.qtd_baldes - 1)];
+    e->proxima_balde = *balde;
+    *balde = e;
+    cache_ligar_inicio(e);
+    cache.bytes += bytes;
+    cache.qtd_entradas++;
+}
+
+static void cache_caminho_disco(char *caminho, size_t tamanho, uint64_t chave) {
+    snprintf(caminho, tamanho, "%s/%016llx.cache", cache.diretorio, (unsigned long long)chave);
+}
+
+/*
+ * Consulta a camada em disco. O arquivo tem 5 linhas: operação, a, b,
+ * resultado e "FIM <dígitos> <hash>" do resultado. Os operandos e o
+ * rodapé são conferidos antes de aceitar o resultado, então um arquivo
+ * truncado ou corrompido conta como falta.
+ */
+static BigInt *cache_ler_disco(uint64_t chave, char op, const BigInt *a, const BigInt *b) {
+    if (cache.diretorio[0] == '\0') return NULL;
+    char caminho[600];
+    cache_caminho_disco(caminho, sizeof(caminho), chave);
+    FILE *f = fopen(caminho, "r");
+    if (!f) return NULL;
+    char *linha_op = ler_linha(f);
+    BigInt *da = ler_bigint_linha(f);
+    BigInt *db = ler_bigint_linha(f);
+    BigInt *resultado = ler_bigint_linha(f);
+    char *rodape = ler_linha(f);
+    fclose(f);
+    int digitos = 0;
+    unsigned long long hash = 0;
+    char sobra;
+    int ok = linha_op && linha_op[0] == op && big_iguais(da, a) && big_iguais(db, b) && resultado
+             && rodape && sscanf(rodape, "FIM %d %llx %c", &digitos, &hash, &sobra) == 2
+             && digitos == resultado->n && hash == big_hash(resultado);
+    free(linha_op);
+    free(rodape);
+    big_destruir(da);
+    big_destruir(db);
+    if (!ok) {
+        big_destruir(resultado);
+        return NULL;
+    }
+    return resultado;
+}
+
+static void cache_gravar_disco(uint64_t chave, char op, const BigInt *a, const BigInt *b,
+                               const BigInt *resultado) {
+    if (cache.diretorio[0] == '\0') return;
+    char caminho[600];
+    cache_caminho_disco(caminho, sizeof(caminho), chave);
+    char temporario[640];
+    arquivo_temporario(temporario, sizeof(temporario), caminho);
+    FILE *f = fopen(temporario, "w");
+    if (!f) return;
+    fprintf(f, "%c\n", op);
+    big_escrever(f, a);
+    fputc('\n', f);
+    big_escrever(f, b);
+    fputc('\n', f);
+    big_escrever(f, resultado);
+    fprintf(f, "\nFIM %d %016llx\n", resultado->n, (unsigned long long)big_hash(resultado));
+    arquivo_publicar(f, temporario, caminho);
+}
+
+/*
+ * Define o limite de memória do cache (0 mantém o atual) e o diretório da
+ * camada persistente (NULL mantém o atual, "" desativa). O diretório
+ * precisa existir.
+ */
+void cache_configurar(size_t limite_bytes, const char *diretorio) {
+    CACHE_TRAVAR();
+    if (limite_bytes > 0) cache.limite_bytes = limite_bytes;
+    while (cache.mais_recente && cache.bytes > cache.limite_bytes) {
+        cache_descartar_lru();
+    }
+    if (diretorio) snprintf(cache.diretorio, sizeof(cache.diretorio), "%s", diretorio);
+    CACHE_DESTRAVAR();
+}
+
+/* Esvazia o cache em memória (a camada em disco é mantida). */
+void cache_limpar(void) {
+    CACHE_TRAVAR();
+    while (cache.mais_recente) {
+        cache_descartar_lru();
+    }
+    free(cache.baldes);
+    cache.baldes = NULL;
+    cache.qtd_baldes = 0;
+    CACHE_DESTRAVAR();
+}
+
+/* Quantidade de acertos e faltas desde o início do programa. */
+void cache_estatisticas(unsigned long long *acertos, unsigned long long *faltas) {
+    CACHE_TRAVAR();
+    if (acertos) *acertos = cache.acertos;
+    if (faltas) *faltas = cache.faltas;
+    CACHE_DESTRAVAR();
+}
+
+/*
+ * Igual a big_avaliar, mas consulta o cache antes de calcular. Devolve
+ * sempre um BigInt novo (o chamador libera). Se "acerto" não for NULL,
+ * recebe 1 quando o resultado veio do cache.
+ */
+BigInt *cache_avaliar(char op, const BigInt *a, const BigInt *b, int *acerto) {
+    if (acerto) *acerto = 0;
+    if (!a || !b) return NULL;
+    if (!cache_operacao_cara(op)) return big_avaliar(op, a, b);
+    uint64_t chave = cache_chave(op, a, b);
+
+    CACHE_TRAVAR();
+    EntradaCache *e = cache_buscar(chave, op, a, b);
+    BigInt *resultado = e ? big_copiar(e->resultado) : NULL;
+    if (resultado) cache.acertos++;
+    CACHE_DESTRAVAR();
+    if (resultado) {
+        if (acerto) *acerto = 1;
+        return resultado;
+    }
+
+    /* O disco e o cálculo ficam fora da trava para não serializar as threads. */
+    resultado = cache_ler_disco(chave, op, a, b);
+    int do_disco = (resultado != NULL);
+    if (!resultado) resultado = big_avaliar(op, a, b);
+    if (!resultado) return NULL;
+    if (!do_disco) cache_gravar_disco(chave, op, a, b, resultado);
+
+    CACHE_TRAVAR();
+    if (do_disco) cache.acertos++;
+    else cache.faltas++;
+    if (!cache_buscar(chave, op, a, b)) cache_inserir(chave, op, a, b, resultado);
+    CACHE_DESTRAVAR();
+    if (acerto) *acerto = do_disco;
+    return resultado;
+}
+
+/* ==============================================================
+                ENTRADA E SAÍDA POR ARQUIVO TXT
+   ============================================================== */
+
+/*
+ * Formato de entrada.txt: uma ou mais operações de 3 linhas cada
+ *   Linha 1: primeiro número (ex: -999999999999)
+ *   Linha 2: operação (+ - * / % m)
+ *   Linha 3: segundo número
+ * Linhas em branco entre operações são ignoradas. saida.txt recebe uma linha
+ * por operação, na mesma ordem ("ERRO" quando a operação falha).
+ *
+ * O processamento é um pipeline de três estágios ligados por filas limitadas:
+ * uma thread leitora (lê e converte os números), threads de cálculo e a
+ * thread principal como escritora (reordena e grava). Assim disco e CPU
+ * trabalham ao mesmo tempo em arquivos com muitas operações.
+ */
+
+/* Capacidade de cada fila do pipeline (potência de 2). */
+#define PIPELINE_CAPACIDADE_FILA 256
+/* Máximo de operações lidas e ainda não gravadas (limita a memória). */
+#define PIPELINE_JANELA 1024
+/* Buffer de leitura/escrita dos arquivos. */
+#define PIPELINE_BUFFER_ARQUIVO (1 << 20)
+/* Resultados exibidos na tela além da gravação em arquivo. */
+#define PIPELINE_ECO_MAX 10
+
+/* Uma operação do arquivo, do momento da leitura até a gravação. */
+typedef struct {
+    long long indice;
+    char op;
+    BigInt *a;
+    BigInt *b;
+    BigInt *resultado;
+    int do_cache;
+    const char *erro;  /* mensagem de erro de leitura, ou NULL */
+} TarefaArquivo;
+
+/* Grava uma linha de resultado ("ERRO" se resultado for NULL). */
+static void gravar_resultado(FILE *f, const BigInt *resultado) {
+    if (!resultado) {
+        fprintf(f, "ERRO\n");
+        return;
+    }
+    big_escrever(f, resultado);
+    fputc('\n', f);
+}
+
+static void tarefa_destruir(TarefaArquivo *t) {
+    if (!t) return;
+    big_destruir(t->a);
+    big_destruir(t->b);
+    big_destruir(t->resultado);
+    free(t);
+}
+
+/* Próxima linha não vazia (pula linhas em branco entre operações). */
+static char *ler_linha_nao_vazia(FILE *f) {
+    char *linha;
+    while ((linha = ler_linha(f)) != NULL && linha[strspn(linha, " \t")] == '\0') {
+        free(linha);
+    }
+    return linha;
+}
+
+/*
+ * Estágio de leitura: lê e converte a próxima operação. Retorna NULL no fim
+ * do arquivo; erros de formato viram tarefas com "erro" preenchido.
+ */
+static TarefaArquivo *ler_tarefa(FILE *f, long long indice) {
+    char *linha1 = ler_linha_nao_vazia(f);
+    if (!linha1) return NULL;
+    char *linha_op = ler_linha(f);
+    char *linha2 = linha_op ? ler_linha(f) : NULL;
+    TarefaArquivo *t = (TarefaArquivo *)calloc(1, sizeof(TarefaArquivo));
+    if (t) {
+        t->indice = indice;
+        if (!linha_op || !linha2) {
+            t->erro = "cada operacao deve ter 3 linhas";
+        } else if (linha_op[0] == '\0') {
+            t->erro = "operacao nao informada";
+        } else {
+            t->op = linha_op[0];
+            t->a = big_criar(linha1);
+            t->b = big_criar(linha2);
+            if (!t->a || !t->b) t->erro = "numero invalido no arquivo";
+        }
     }
+    free(linha1);
+    free(linha_op);
+    free(linha2);
+    return t;
 }
 
-/* ==============================================================
-                ENTRADA E SAÍDA POR ARQUIVO TXT
-   ============================================================== */
+/* Estágio de cálculo. */
+static void calcular_tarefa(TarefaArquivo *t) {
+    if (!t->erro) t->resultado = cache_avaliar(t->op, t->a, t->b, &t->do_cache);
+}
 
-/* Lê o arquivo entrada.txt com exatamente 3 linhas:
-   Linha 1: primeiro número (ex: -999999999999)
-   Linha 2: operação (+ - * / %)
-   Linha 3: segundo número
-   Retorna 1 se sucesso, 0 se erro */
-int ler_entrada_txt(BigInt **a, char *op, BigInt **b) {
-    FILE *f = fopen("entrada.txt", "r");
-    if (!f) {
-        printf("ERRO: arquivo 'entrada.txt' nao encontrado!\n");
-        printf("      Crie o arquivo na mesma pasta do executavel.\n");
-        return 0;
+/* Estágio de escrita: grava a tarefa e, para as primeiras, mostra na tela. */
+static void escrever_tarefa(FILE *saida, const TarefaArquivo *t, long long *erros) {
+    if (t->erro) {
+        printf("ERRO: operacao %lld: %s!\n", t->indice + 1, t->erro);
+    }
+    if (!t->resultado) (*erros)++;
+    gravar_resultado(saida, t->resultado);
+    if (t->indice < PIPELINE_ECO_MAX && t->resultado) {
+        printf("[%lld] ", t->indice + 1);
+        big_imprimir(t->a);
+        printf(" %c ", t->op);
+        big_imprimir(t->b);
+        printf(" = ");
+        big_imprimir(t->resultado);
+        printf("%s\n", t->do_cache ? " (cache)" : "");
     }
+}
 
-    char linha1[10010] = {0};
-    char linha_op[10]  = {0};
-    char linha2[10010] = {0};
+#ifndef CALC_SEM_THREADS
+/* Tentativas antes de dormir: metade girando, metade cedendo o processador. */
+#define EVENTO_GIROS 128
 
-    if (!fgets(linha1, sizeof(linha1), f) ||
-        !fgets(linha_op, sizeof(linha_op), f) ||
-        !fgets(linha2, sizeof(linha2), f)) {
-        printf("ERRO: 'entrada.txt' deve ter exatamente 3 linhas!\n");
-        fclose(f);
-        return 0;
+/*
+ * Ponto de espera para uma condição mantida por atômicos (fila não vazia,
+ * fila não cheia, janela livre). Quem espera tenta por EVENTO_GIROS vezes e
+ * depois dorme na variável de condição; quem muda a condição só pega a trava
+ * para acordar se houver alguém dormindo ("esperando" > 0).
+ */
+typedef struct {
+    pthread_mutex_t trava;
+    pthread_cond_t sinal;
+    atomic_int esperando;
+} Evento;
+
+static void evento_criar(Evento *e) {
+    pthread_mutex_init(&e->trava, NULL);
+    pthread_cond_init(&e->sinal, NULL);
+    atomic_init(&e->esperando, 0);
+}
+
+static void evento_destruir(Evento *e) {
+    pthread_cond_destroy(&e->sinal);
+    pthread_mutex_destroy(&e->trava);
+}
+
+/* Espera até "pronto(arg)" retornar verdadeiro. */
+static void evento_esperar(Evento *e, int (*pronto)(void *), void *arg) {
+    for (int i = 0; i < EVENTO_GIROS; i++) {
+        if (pronto(arg)) return;
+        if (i >= EVENTO_GIROS / 2) sched_yield();
     }
-    fclose(f);
+    pthread_mutex_lock(&e->trava);
+    atomic_fetch_add(&e->esperando, 1);
+    /* Par da barreira de evento_avisar: ou o aviso vê "esperando", ou pronto vê a mudança. */
+    atomic_thread_fence(memory_order_seq_cst);
+    while (!pronto(arg)) pthread_cond_wait(&e->sinal, &e->trava);
+    atomic_fetch_sub(&e->esperando, 1);
+    pthread_mutex_unlock(&e->trava);
+}
+
+/* Chamado depois de mudar a condição: acorda quem estiver dormindo. */
+static void evento_avisar(Evento *e) {
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&e->esperando, memory_order_relaxed) > 0) {
+        pthread_mutex_lock(&e->trava);
+        pthread_cond_broadcast(&e->sinal);
+        pthread_mutex_unlock(&e->trava);
+    }
+}
 
-    // Remove \n e \r do final das linhas
-    linha1[strcspn(linha1, "\r\n")] = '\0';
-    linha_op[strcspn(linha_op, "\r\n")] = '\0';
-    linha2[strcspn(linha2, "\r\n")] = '\0';
+/*
+ * Fila limitada sem trava para vários produtores e consumidores
+ * (D. Vyukov, "Bounded MPMC queue"). Cada célula tem um número de sequência
+ * que indica se está livre para o produtor ou pronta para o consumidor.
+ */
+typedef struct {
+    atomic_size_t sequencia;
+    void *dado;
+} CelulaFila;
 
-    *a = big_criar(linha1);
-    *b = big_criar(linha2);
+typedef struct {
+    CelulaFila *celulas;
+    size_t mascara;
+    atomic_size_t inicio;  /* próxima posição a consumir */
+    atomic_size_t fim;     /* próxima posição a produzir */
+    Evento nao_vazia;
+    Evento nao_cheia;
+} FilaLimitada;
 
-    if (!*a || !*b) {
-        printf("ERRO: numero invalido no arquivo!\n");
-        if (*a) big_destruir(*a);
-        if (*b) big_destruir(*b);
-        return 0;
+static int fila_criar(FilaLimitada *fila, size_t capacidade) {
+    fila->celulas = (CelulaFila *)malloc(capacidade * sizeof(CelulaFila));
+    if (!fila->celulas) return -1;
+    for (size_t i = 0; i < capacidade; i++) {
+        atomic_init(&fila->celulas[i].sequencia, i);
+        fila->celulas[i].dado = NULL;
     }
+    fila->mascara = capacidade - 1;
+    atomic_init(&fila->inicio, 0);
+    atomic_init(&fila->fim, 0);
+    evento_criar(&fila->nao_vazia);
+    evento_criar(&fila->nao_cheia);
+    return 0;
+}
 
-    if (strlen(linha_op) == 0) {
-        printf("ERRO: operacao nao informada!\n");
-        big_destruir(*a); big_destruir(*b);
-        return 0;
+static void fila_destruir(FilaLimitada *fila) {
+    evento_destruir(&fila->nao_vazia);
+    evento_destruir(&fila->nao_cheia);
+    free(fila->celulas);
+    fila->celulas = NULL;
+}
+
+/* Tenta enfileirar; retorna 0 se a fila estiver cheia. */
+static int fila_tentar_inserir(FilaLimitada *fila, void *dado) {
+    size_t pos = atomic_load_explicit(&fila->fim, memory_order_relaxed);
+    for (;;) {
+        CelulaFila *celula = &fila->celulas[pos & fila->mascara];
+        size_t seq = atomic_load_explicit(&celula->sequencia, memory_order_acquire);
+        intptr_t dif = (intptr_t)seq - (intptr_t)pos;
+        if (dif == 0) {
+            if (atomic_compare_exchange_weak_explicit(&fila->fim, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                celula->dado = dado;
+                atomic_store_explicit(&celula->sequencia, pos + 1, memory_order_release);
+                return 1;
+            }
+        } else if (dif < 0) {
+            return 0;
+        } else {
+            pos = atomic_load_explicit(&fila->fim, memory_order_relaxed);
+        }
     }
+}
 
-    *op = linha_op[0];
-    return 1; // sucesso!
+/* Tenta desenfileirar; retorna 0 se a fila estiver vazia. */
+static int fila_tentar_remover(FilaLimitada *fila, void **dado) {
+    size_t pos = atomic_load_explicit(&fila->inicio, memory_order_relaxed);
+    for (;;) {
+        CelulaFila *celula = &fila->celulas[pos & fila->mascara];
+        size_t seq = atomic_load_explicit(&celula->sequencia, memory_order_acquire);
+        intptr_t dif = (intptr_t)seq - (intptr_t)(pos + 1);
+        if (dif == 0) {
+            if (atomic_compare_exchange_weak_explicit(&fila->inicio, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                *dado = celula->dado;
+                atomic_store_explicit(&celula->sequencia, pos + fila->mascara + 1,
+                                      memory_order_release);
+                return 1;
+            }
+        } else if (dif < 0) {
+            return 0;
+        } else {
+            pos = atomic_load_explicit(&fila->inicio, memory_order_relaxed);
+        }
+    }
 }
 
-/* Grava o resultado no arquivo saida.txt */
-void gravar_saida_txt(const BigInt *resultado) {
-    FILE *f = fopen("saida.txt", "w");
-    if (!f) {
-        printf("ERRO: nao foi possivel criar 'saida.txt'\n");
-        return;
+/* Operação pendente de fila_inserir/fila_remover, tentada por evento_esperar. */
+typedef struct {
+    FilaLimitada *fila;
+    void *dado;
+} OperacaoFila;
+
+static int fila_pronta_inserir(void *arg) {
+    OperacaoFila *op = (OperacaoFila *)arg;
+    return fila_tentar_inserir(op->fila, op->dado);
+}
+
+static int fila_pronta_remover(void *arg) {
+    OperacaoFila *op = (OperacaoFila *)arg;
+    return fila_tentar_remover(op->fila, &op->dado);
+}
+
+/* Insere, dormindo enquanto a fila estiver cheia. */
+static void fila_inserir(FilaLimitada *fila, void *dado) {
+    OperacaoFila op = { fila, dado };
+    evento_esperar(&fila->nao_cheia, fila_pronta_inserir, &op);
+    evento_avisar(&fila->nao_vazia);
+}
+
+/* Remove, dormindo enquanto a fila estiver vazia. */
+static void *fila_remover(FilaLimitada *fila) {
+    OperacaoFila op = { fila, NULL };
+    evento_esperar(&fila->nao_vazia, fila_pronta_remover, &op);
+    evento_avisar(&fila->nao_cheia);
+    return op.dado;
+}
+
+/* Estado compartilhado entre os estágios do pipeline. */
+typedef struct {
+    FILE *entrada;
+    FilaLimitada para_calculo;
+    FilaLimitada para_escrita;
+    int qtd_calculo;
+    TarefaArquivo **pendentes;  /* anel de reordenação da escritora */
+    atomic_llong lidas;      /* -1 enquanto a leitura não termina */
+    atomic_llong gravadas;
+    Evento janela;           /* a escritora gravou: a leitora pode avançar */
+} Pipeline;
+
+/* Marca de fim enviada a cada thread de cálculo. */
+static TarefaArquivo pipeline_fim;
+
+/* Posição da leitora, conferida contra a janela por evento_esperar. */
+typedef struct {
+    Pipeline *p;
+    long long indice;
+} EsperaLeitor;
+
+static int leitor_pronto(void *arg) {
+    EsperaLeitor *e = (EsperaLeitor *)arg;
+    return e->indice - atomic_load(&e->p->gravadas) < PIPELINE_JANELA;
+}
+
+static void *pipeline_leitor(void *arg) {
+    Pipeline *p = (Pipeline *)arg;
+    EsperaLeitor espera = { p, 0 };
+    TarefaArquivo *t;
+    for (;;) {
+        /* Respeita a janela para que a escritora não acumule resultados. */
+        evento_esperar(&p->janela, leitor_pronto, &espera);
+        if ((t = ler_tarefa(p->entrada, espera.indice)) == NULL) break;
+        fila_inserir(&p->para_calculo, t);
+        espera.indice++;
+    }
+    for (int i = 0; i < p->qtd_calculo; i++) {
+        fila_inserir(&p->para_calculo, &pipeline_fim);
     }
+    atomic_store(&p->lidas, espera.indice);
+    /* A escritora pode estar dormindo à espera da próxima tarefa. */
+    evento_avisar(&p->para_escrita.nao_vazia);
+    return NULL;
+}
 
-    if (!resultado) {
-        fprintf(f, "ERRO\n");
-    } else {
-        // Imprime sinal negativo se necessário
-        if (resultado->sinal < 0 && !(resultado->n == 1 && resultado->digitos[0] == 0)) {
-            fprintf(f, "-");
+static void *pipeline_calculo(void *arg) {
+    Pipeline *p = (Pipeline *)arg;
+    TarefaArquivo *t;
+    while ((t = (TarefaArquivo *)fila_remover(&p->para_calculo)) != &pipeline_fim) {
+        calcular_tarefa(t);
+        fila_inserir(&p->para_escrita, t);
+    }
+    return NULL;
+}
+
+/* Estado da escritora: acorda com uma tarefa nova ou quando tudo foi gravado. */
+typedef struct {
+    Pipeline *p;
+    long long proxima;
+    void *dado;
+} EsperaEscritor;
+
+static int escritor_pronto(void *arg) {
+    EsperaEscritor *e = (EsperaEscritor *)arg;
+    if (fila_tentar_remover(&e->p->para_escrita, &e->dado)) return 1;
+    long long lidas = atomic_load(&e->p->lidas);
+    return lidas >= 0 && e->proxima >= lidas;
+}
+
+/*
+ * Estágio de escrita (thread atual): recebe as tarefas fora de ordem e grava
+ * na ordem do arquivo, usando um anel indexado por indice % PIPELINE_JANELA.
+ */
+static long long pipeline_escritor(Pipeline *p, FILE *saida, long long *erros) {
+    TarefaArquivo **pendentes = p->pendentes;
+    EsperaEscritor espera = { p, 0, NULL };
+    for (;;) {
+        espera.dado = NULL;
+        evento_esperar(&p->para_escrita.nao_vazia, escritor_pronto, &espera);
+        if (!espera.dado) break;
+        evento_avisar(&p->para_escrita.nao_cheia);
+        TarefaArquivo *t = (TarefaArquivo *)espera.dado;
+        pendentes[t->indice % PIPELINE_JANELA] = t;
+        long long antes = espera.proxima;
+        while ((t = pendentes[espera.proxima % PIPELINE_JANELA]) != NULL
+               && t->indice == espera.proxima) {
+            escrever_tarefa(saida, t, erros);
+            pendentes[espera.proxima % PIPELINE_JANELA] = NULL;
+            tarefa_destruir(t);
+            espera.proxima++;
+            atomic_store(&p->gravadas, espera.proxima);
+        }
+        if (espera.proxima != antes) evento_avisar(&p->janela);
+    }
+    return espera.proxima;
+}
+#endif
+
+/*
+ * Processa todas as operações de "caminho_entrada" e grava os resultados em
+ * "caminho_saida". Retorna a quantidade de operações ou -1 em erro.
+ */
+long long processar_arquivo(const char *caminho_entrada, const char *caminho_saida,
+                            long long *erros) {
+    *erros = 0;
+    FILE *entrada = fopen(caminho_entrada, "r");
+    if (!entrada) {
+        printf("ERRO: arquivo '%s' nao encontrado!\n", caminho_entrada);
+        printf("      Crie o arquivo na mesma pasta do executavel.\n");
+        return -1;
+    }
+    FILE *saida = fopen(caminho_saida, "w");
+    if (!saida) {
+        printf("ERRO: nao foi possivel criar '%s'\n", caminho_saida);
+        fclose(entrada);
+        return -1;
+    }
+    setvbuf(entrada, NULL, _IOFBF, PIPELINE_BUFFER_ARQUIVO);
+    setvbuf(saida, NULL, _IOFBF, PIPELINE_BUFFER_ARQUIVO);
+    long long total = -1;
+#ifndef CALC_SEM_THREADS
+    Pipeline p;
+    p.entrada = entrada;
+    p.qtd_calculo = calc_num_nucleos();
+    atomic_init(&p.lidas, -1);
+    atomic_init(&p.gravadas, 0);
+    evento_criar(&p.janela);
+    pthread_t leitor;
+    pthread_t *calculo = (pthread_t *)malloc(p.qtd_calculo * sizeof(pthread_t));
+    p.pendentes = (TarefaArquivo **)calloc(PIPELINE_JANELA, sizeof(TarefaArquivo *));
+    int filas = fila_criar(&p.para_calculo, PIPELINE_CAPACIDADE_FILA) == 0;
+    if (filas && fila_criar(&p.para_escrita, PIPELINE_CAPACIDADE_FILA) != 0) {
+        fila_destruir(&p.para_calculo);
+        filas = 0;
+    }
+    if (calculo && p.pendentes && filas) {
+        int criadas = 0;
+        while (criadas < p.qtd_calculo
+               && pthread_create(&calculo[criadas], NULL, pipeline_calculo, &p) == 0) {
+            criadas++;
+        }
+        p.qtd_calculo = criadas;
+        if (criadas > 0 && pthread_create(&leitor, NULL, pipeline_leitor, &p) == 0) {
+            total = pipeline_escritor(&p, saida, erros);
+            pthread_join(leitor, NULL);
+        } else {
+            /* Sem leitora: libera as threads de cálculo e cai no modo sequencial. */
+            for (int i = 0; i < criadas; i++) {
+                fila_inserir(&p.para_calculo, &pipeline_fim);
+            }
         }
-        // Imprime dígitos do mais significativo para o menos
-        for (int i = resultado->n - 1; i >= 0; i--) {
-            fprintf(f, "%d", resultado->digitos[i]);
+        for (int i = 0; i < criadas; i++) {
+            pthread_join(calculo[i], NULL);
         }
-        fprintf(f, "\n");
     }
-    fclose(f);
-    printf("Resultado gravado em 'saida.txt'\n");
+    if (filas) {
+        fila_destruir(&p.para_calculo);
+        fila_destruir(&p.para_escrita);
+    }
+    free(calculo);
+    free(p.pendentes);
+    evento_destruir(&p.janela);
+#endif
+    if (total < 0) {
+        /* Modo sequencial: os mesmos estágios, um após o outro. */
+        TarefaArquivo *t;
+        total = 0;
+        while ((t = ler_tarefa(entrada, total)) != NULL) {
+            calcular_tarefa(t);
+            escrever_tarefa(saida, t, erros);
+            tarefa_destruir(t);
+            total++;
+        }
+    }
+    fclose(entrada);
+    if (fclose(saida) != 0) {
+        printf("ERRO: falha ao gravar '%s'\n", caminho_saida);
+        return -1;
+    }
+    return total;
 }
 
 /* Função chamada quando o usuário escolhe entrada por arquivo */
 void menu_bigint_arquivo() {
-    BigInt *x = NULL, *y = NULL, *res = NULL;
-    char operacao;
-
     printf("\nLendo dados de 'entrada.txt'...\n");
-
-    if (!ler_entrada_txt(&x, &operacao, &y)) {
+    long long erros = 0;
+    long long total = processar_arquivo("entrada.txt", "saida.txt", &erros);
+    if (total < 0) {
         return; // erro já foi informado
     }
+    if (total == 0) {
+        printf("ERRO: 'entrada.txt' nao contem nenhuma operacao!\n");
+        return;
+    }
+    printf("%lld operacao(oes) processada(s), %lld com erro.\n", total, erros);
+    printf("Resultado gravado em 'saida.txt'\n");
+}
 
-    printf("Operacao detectada: ");
-    big_imprimir(x);
-    printf(" %c ", operacao);
-    big_imprimir(y);
-    printf("\n");
+/* ==============================================================
+                MODO SERVIDOR (SOCKET UNIX)
+   ============================================================== */
 
-    switch (operacao) {
-        case '+': res = big_somar(x, y);    break;
-        case '-': res = big_subtrair(x, y); break;
-        case '*': res = big_multiplicar(x,y); break;
-        case '/': res = big_dividir(x, y);  break;
-        case '%': res = big_mod(x, y);      break;
-        default:
-            printf("Operacao '%c' nao suportada!\n", operacao);
-            big_destruir(x); big_destruir(y);
-            return;
+#ifdef CALC_SERVIDOR
+/*
+ * Servidor local: aceita conexões em um socket de domínio Unix e as atende
+ * com um pool de threads criado na inicialização. A thread principal vigia
+ * todas as conexões com poll e entrega ao pool só as que têm dados; a thread
+ * lê o que houver sem bloquear, responde e devolve a conexão, de modo que um
+ * cliente ocioso não prende nenhuma thread. O socket do cliente é não
+ * bloqueante e cada conexão guarda seu pedido incompleto e as respostas
+ * ainda não enviadas: enquanto houver respostas pendentes (cliente que não
+ * lê), a conexão volta ao poll esperando POLLOUT e sua entrada não é lida,
+ * então nenhuma thread fica presa em um send. Um cliente pode mandar vários
+ * pedidos sem esperar respostas
+ * (pipelining): todos os pedidos completos de uma leitura são avaliados e
+ * respondidos em uma única escrita, na ordem em que chegaram.
+ *
+ * Pedido texto (uma linha):  <a> <op> <b>     ex: "123 * -456"
+ *   resposta: "OK <resultado>" ou "ERRO <mensagem>"
+ * Comandos texto: "STATS" (contadores e percentis de latência) e "ENCERRAR".
+ *
+ * Pedido binário: 0xB1, op (1 byte), e para cada operando: sinal (1 byte,
+ * 0 = positivo, 1 = negativo), n (uint32 little-endian) e n bytes com os
+ * dígitos 0-9 do menos para o mais significativo.
+ *   resposta: 0xB1, status (0 = OK, 1 = erro), sinal, n, dígitos.
+ */
+
+/* Byte inicial de um pedido binário (fora do ASCII, não confunde com texto). */
+#define SERVIDOR_BINARIO 0xB1
+/* Bytes lidos do socket por chamada. */
+#define SERVIDOR_LEITURA (64 * 1024)
+/* Tamanho máximo de um pedido (protege a memória do servidor). */
+#define SERVIDOR_MAX_PEDIDO (64u * 1024u * 1024u)
+/* Amostras de latência guardadas para os percentis (as mais recentes). */
+#define SERVIDOR_AMOSTRAS 65536
+/* Conexões abertas ao mesmo tempo. */
+#define SERVIDOR_MAX_CONEXOES 1024
+/* Leituras seguidas de uma conexão antes de devolvê-la ao poll (justiça). */
+#define SERVIDOR_LEITURAS_POR_VEZ 8
+
+/* Buffer que cresce sob demanda e é reaproveitado (um de entrada e um de saída por conexão). */
+typedef struct {
+    char *dados;
+    size_t tamanho;
+    size_t capacidade;
+} BufferArena;
+
+/*
+ * Conexão aberta. Enquanto "ocupada", uma thread do pool a atende e a thread
+ * principal não a vigia; "fechada" pede que a principal a feche e libere;
+ * "escrita" indica respostas pendentes (a principal espera POLLOUT em vez de
+ * POLLIN). Os três campos são protegidos pela trava do servidor.
+ */
+typedef struct {
+    int fd;
+    int ocupada;
+    int fechada;
+    int escrita;
+    BufferArena entrada;
+    BufferArena saida;
+} Conexao;
+
+/* Estado global do servidor. */
+typedef struct {
+    int socket_escuta;
+    int acordar[2];
+    atomic_int encerrar;
+    pthread_mutex_t trava;
+    pthread_cond_t tem_conexao;
+    /* Conexões com dados aguardando uma thread livre. */
+    Conexao *prontas[SERVIDOR_MAX_CONEXOES];
+    int qtd_prontas;
+    /* Estatísticas (protegidas por "trava"). */
+    unsigned long long pedidos;
+    unsigned long long erros;
+    unsigned long long conexoes;
+    unsigned int latencias_us[SERVIDOR_AMOSTRAS];
+    unsigned long long qtd_latencias;
+} Servidor;
+
+static Servidor servidor;
+
+/* Acorda o poll da thread principal (conexão devolvida ou ENCERRAR). */
+static void servidor_acordar(void) {
+    char byte = 1;
+    ssize_t escritos = write(servidor.acordar[1], &byte, 1);
+    (void)escritos;
+}
+
+static int arena_reservar(BufferArena *b, size_t tamanho) {
+    if (tamanho <= b->capacidade) return 0;
+    size_t nova = b->capacidade ? b->capacidade : SERVIDOR_LEITURA;
+    while (nova < tamanho) nova *= 2;
+    char *dados = (char *)realloc(b->dados, nova);
+    if (!dados) return -1;
+    b->dados = dados;
+    b->capacidade = nova;
+    return 0;
+}
+
+static int arena_anexar(BufferArena *b, const void *dados, size_t tamanho) {
+    if (arena_reservar(b, b->tamanho + tamanho) != 0) return -1;
+    memcpy(b->dados + b->tamanho, dados, tamanho);
+    b->tamanho += tamanho;
+    return 0;
+}
+
+static int arena_texto(BufferArena *b, const char *texto) {
+    return arena_anexar(b, texto, strlen(texto));
+}
+
+/* Anexa um BigInt em decimal. */
+static int arena_bigint(BufferArena *b, const BigInt *x) {
+    if (arena_reservar(b, b->tamanho + (size_t)x->n + 1) != 0) return -1;
+    if (x->sinal < 0 && !big_eh_zero(x)) b->dados[b->tamanho++] = '-';
+    for (int i = x->n - 1; i >= 0; i--) {
+        b->dados[b->tamanho++] = (char)('0' + x->digitos[i]);
     }
+    return 0;
+}
 
-    if (res) {
-        printf("Resultado: ");
-        big_imprimir(res);
-        printf("\n");
-        gravar_saida_txt(res);
-        big_destruir(res);
+static unsigned long long relogio_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000ULL + (unsigned long long)ts.tv_nsec / 1000ULL;
+}
+
+static void servidor_registrar(unsigned long long inicio_us, int erro) {
+    unsigned long long decorrido = relogio_us() - inicio_us;
+    pthread_mutex_lock(&servidor.trava);
+    servidor.pedidos++;
+    if (erro) servidor.erros++;
+    servidor.latencias_us[servidor.qtd_latencias % SERVIDOR_AMOSTRAS] =
+        (decorrido > 0xFFFFFFFFULL) ? 0xFFFFFFFFu : (unsigned int)decorrido;
+    servidor.qtd_latencias++;
+    pthread_mutex_unlock(&servidor.trava);
+}
+
+static int comparar_uint(const void *a, const void *b) {
+    unsigned int x = *(const unsigned int *)a, y = *(const unsigned int *)b;
+    return (x > y) - (x < y);
+}
+
+/* Resposta do comando STATS: contadores e percentis das latências recentes. */
+static int servidor_stats(BufferArena *saida) {
+    static unsigned int copia[SERVIDOR_AMOSTRAS];
+    static pthread_mutex_t trava_copia = PTHREAD_MUTEX_INITIALIZER;
+    unsigned long long acertos, faltas;
+    cache_estatisticas(&acertos, &faltas);
+    pthread_mutex_lock(&trava_copia);
+    pthread_mutex_lock(&servidor.trava);
+    size_t qtd = (servidor.qtd_latencias < SERVIDOR_AMOSTRAS)
+                     ? (size_t)servidor.qtd_latencias : SERVIDOR_AMOSTRAS;
+    memcpy(copia, servidor.latencias_us, qtd * sizeof(unsigned int));
+    unsigned long long pedidos = servidor.pedidos, erros = servidor.erros;
+    unsigned long long conexoes = servidor.conexoes;
+    pthread_mutex_unlock(&servidor.trava);
+    qsort(copia, qtd, sizeof(unsigned int), comparar_uint);
+    unsigned int p50 = qtd ? copia[(qtd - 1) * 50 / 100] : 0;
+    unsigned int p90 = qtd ? copia[(qtd - 1) * 90 / 100] : 0;
+    unsigned int p99 = qtd ? copia[(qtd - 1) * 99 / 100] : 0;
+    unsigned int maximo = qtd ? copia[qtd - 1] : 0;
+    pthread_mutex_unlock(&trava_copia);
+    char linha[320];
+    snprintf(linha, sizeof(linha),
+             "OK pedidos=%llu erros=%llu conexoes=%llu cache_acertos=%llu cache_faltas=%llu "
+             "p50_us=%u p90_us=%u p99_us=%u max_us=%u\n",
+             pedidos, erros, conexoes, acertos, faltas, p50, p90, p99, maximo);
+    return arena_texto(saida, linha);
+}
+
+/* Confere que o resultado é um número bem formado (sinal +-1, dígitos 0-9). */
+static int servidor_resultado_valido(const BigInt *r) {
+    if (r->n < 1 || (r->sinal != 1 && r->sinal != -1)) return 0;
+    for (int i = 0; i < r->n; i++) {
+        if (r->digitos[i] < 0 || r->digitos[i] > 9) return 0;
+    }
+    return 1;
+}
+
+/*
+ * Valida e avalia; em erro devolve NULL e a mensagem em *erro. Um resultado
+ * malformado nunca é enviado como sucesso.
+ */
+static BigInt *servidor_avaliar(char op, const BigInt *a, const BigInt *b, const char **erro) {
+    if (!strchr("+-*/%m", op) || op == '\0') {
+        *erro = "operacao nao suportada";
+        return NULL;
+    }
+    if ((op == '/' || op == '%') && big_eh_zero(b)) {
+        *erro = "divisao por zero";
+        return NULL;
+    }
+    BigInt *r = cache_avaliar(op, a, b, NULL);
+    if (r && !servidor_resultado_valido(r)) {
+        big_destruir(r);
+        r = NULL;
     }
+    if (!r) *erro = "falha no calculo";
+    return r;
+}
 
-    big_destruir(x);
-    big_destruir(y);
+/* Trata uma linha de texto (sem o '\n'). Retorna -1 se a arena estourar. */
+static int servidor_linha(char *linha, BufferArena *saida) {
+    unsigned long long inicio = relogio_us();
+    size_t len = strlen(linha);
+    if (len > 0 && linha[len - 1] == '\r') linha[--len] = '\0';
+    if (strcmp(linha, "STATS") == 0) return servidor_stats(saida);
+    if (strcmp(linha, "ENCERRAR") == 0) {
+        atomic_store(&servidor.encerrar, 1);
+        servidor_acordar();
+        return arena_texto(saida, "OK\n");
+    }
+    char *contexto = NULL;
+    char *texto_a = strtok_r(linha, " \t", &contexto);
+    char *texto_op = strtok_r(NULL, " \t", &contexto);
+    char *texto_b = strtok_r(NULL, " \t", &contexto);
+    const char *erro = NULL;
+    BigInt *a = NULL, *b = NULL, *r = NULL;
+    if (!texto_a || !texto_op || !texto_b || texto_op[1] != '\0'
+        || strtok_r(NULL, " \t", &contexto)) {
+        erro = "formato esperado: <a> <op> <b>";
+    } else if (!(a = big_criar(texto_a)) || !(b = big_criar(texto_b))) {
+        erro = "numero invalido";
+    } else {
+        r = servidor_avaliar(texto_op[0], a, b, &erro);
+    }
+    int status;
+    if (r) {
+        status = arena_texto(saida, "OK ") | arena_bigint(saida, r) | arena_texto(saida, "\n");
+    } else {
+        status = arena_texto(saida, "ERRO ") | arena_texto(saida, erro) | arena_texto(saida, "\n");
+    }
+    big_destruir(a);
+    big_destruir(b);
+    big_destruir(r);
+    servidor_registrar(inicio, r == NULL);
+    return status;
+}
+
+static uint32_t ler_u32(const unsigned char *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/*
+ * Lê um operando binário em p[0..disponivel). Retorna os bytes consumidos,
+ * 0 se o operando ainda não chegou inteiro, ou -1 se for inválido.
+ */
+static long long servidor_operando_binario(const unsigned char *p, size_t disponivel, BigInt **x) {
+    if (disponivel < 5) return 0;
+    uint32_t n = ler_u32(p + 1);
+    if (n == 0 || n > SERVIDOR_MAX_PEDIDO) return -1;
+    if (disponivel < 5 + (size_t)n) return 0;
+    *x = big_criar_zero((int)n);
+    if (!*x) return -1;
+    (*x)->n = (int)n;
+    (*x)->sinal = p[0] ? -1 : 1;
+    for (uint32_t i = 0; i < n; i++) {
+        if (p[5 + i] > 9) {
+            big_destruir(*x);
+            *x = NULL;
+            return -1;
+        }
+        (*x)->digitos[i] = p[5 + i];
+    }
+    big_normalizar(*x);
+    return 5 + (long long)n;
+}
+
+static int servidor_resposta_binaria(BufferArena *saida, const BigInt *r) {
+    unsigned char cabecalho[7] = { SERVIDOR_BINARIO, r ? 0 : 1, 0, 0, 0, 0, 0 };
+    uint32_t n = r ? (uint32_t)r->n : 0;
+    if (r) cabecalho[2] = (r->sinal < 0 && !big_eh_zero(r)) ? 1 : 0;
+    for (int i = 0; i < 4; i++) cabecalho[3 + i] = (unsigned char)(n >> (8 * i));
+    if (arena_anexar(saida, cabecalho, sizeof(cabecalho)) != 0) return -1;
+    if (!r) return 0;
+    if (arena_reservar(saida, saida->tamanho + n) != 0) return -1;
+    for (uint32_t i = 0; i < n; i++) {
+        saida->dados[saida->tamanho++] = (char)r->digitos[i];
+    }
+    return 0;
+}
+
+/*
+ * Trata um pedido binário no início de p. Retorna os bytes consumidos,
+ * 0 se o pedido está incompleto ou -1 se for inválido (fecha a conexão).
+ */
+static long long servidor_binario(const unsigned char *p, size_t disponivel, BufferArena *saida) {
+    unsigned long long inicio = relogio_us();
+    if (disponivel < 2) return 0;
+    BigInt *a = NULL, *b = NULL;
+    long long usados_a = servidor_operando_binario(p + 2, disponivel - 2, &a);
+    if (usados_a <= 0) return usados_a;
+    long long usados_b = servidor_operando_binario(p + 2 + usados_a, disponivel - 2 - (size_t)usados_a, &b);
+    if (usados_b <= 0) {
+        big_destruir(a);
+        return usados_b;
+    }
+    const char *erro = NULL;
+    BigInt *r = servidor_avaliar((char)p[1], a, b, &erro);
+    int status = servidor_resposta_binaria(saida, r);
+    servidor_registrar(inicio, r == NULL);
+    big_destruir(a);
+    big_destruir(b);
+    big_destruir(r);
+    return (status == 0) ? 2 + usados_a + usados_b : -1;
+}
+
+/*
+ * Processa todos os pedidos completos da entrada, acumulando as respostas.
+ * Retorna os bytes consumidos ou -1 se a conexão deve ser fechada.
+ */
+static long long servidor_processar(BufferArena *entrada, BufferArena *saida) {
+    unsigned char *dados = (unsigned char *)entrada->dados;
+    size_t tamanho = entrada->tamanho;
+    size_t pos = 0;
+    while (pos < tamanho && !atomic_load(&servidor.encerrar)) {
+        if (dados[pos] == SERVIDOR_BINARIO) {
+            long long usados = servidor_binario(dados + pos, tamanho - pos, saida);
+            if (usados < 0) return -1;
+            if (usados == 0) break;
+            pos += (size_t)usados;
+            continue;
+        }
+        unsigned char *fim = (unsigned char *)memchr(dados + pos, '\n', tamanho - pos);
+        if (!fim) break;
+        *fim = '\0';
+        if (fim > dados + pos && servidor_linha((char *)dados + pos, saida) != 0) return -1;
+        pos = (size_t)(fim - dados) + 1;
+    }
+    return (long long)pos;
+}
+
+/*
+ * Envia sem bloquear o que couber das respostas pendentes da conexão.
+ * Retorna 0 se tudo foi enviado, 1 se ainda há pendências (socket cheio) e
+ * -1 em erro.
+ */
+static int conexao_enviar(Conexao *c) {
+    size_t enviado = 0;
+    int status = 0;
+    while (enviado < c->saida.tamanho) {
+        ssize_t n = send(c->fd, c->saida.dados + enviado, c->saida.tamanho - enviado,
+                         MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            status = 1;
+            break;
+        }
+        if (n <= 0) return -1;
+        enviado += (size_t)n;
+    }
+    c->saida.tamanho -= enviado;
+    memmove(c->saida.dados, c->saida.dados + enviado, c->saida.tamanho);
+    return status;
+}
+
+/*
+ * Envia as respostas pendentes e, se o socket aceitou tudo, lê sem
+ * bloquear o que a conexão tiver, responde os pedidos completos e guarda o
+ * resto para a próxima vez. Retorna 0 para voltar a esperar pedidos, 1 para
+ * esperar o socket aceitar mais respostas e -1 se a conexão deve ser
+ * fechada (cliente fechou, erro ou pedido grande demais).
+ */
+static int servidor_atender(Conexao *c) {
+    int status = conexao_enviar(c);
+    for (int leituras = 0; status == 0 && leituras < SERVIDOR_LEITURAS_POR_VEZ; leituras++) {
+        if (arena_reservar(&c->entrada, c->entrada.tamanho + SERVIDOR_LEITURA) != 0) return -1;
+        ssize_t lidos = recv(c->fd, c->entrada.dados + c->entrada.tamanho, SERVIDOR_LEITURA,
+                             MSG_DONTWAIT);
+        if (lidos < 0 && errno == EINTR) continue;
+        if (lidos < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return 0;
+        if (lidos <= 0) return -1;
+        c->entrada.tamanho += (size_t)lidos;
+        long long consumidos = servidor_processar(&c->entrada, &c->saida);
+        if (consumidos < 0) {
+            conexao_enviar(c);
+            return -1;
+        }
+        c->entrada.tamanho -= (size_t)consumidos;
+        memmove(c->entrada.dados, c->entrada.dados + consumidos, c->entrada.tamanho);
+        if (c->entrada.tamanho > SERVIDOR_MAX_PEDIDO) {
+            arena_texto(&c->saida, "ERRO pedido muito grande\n");
+            conexao_enviar(c);
+            return -1;
+        }
+        status = conexao_enviar(c);
+    }
+    return status;
+}
+
+/* Thread do pool: pega conexões com dados, atende e as devolve ao poll. */
+static void *servidor_trabalhador(void *arg) {
+    (void)arg;
+    for (;;) {
+        pthread_mutex_lock(&servidor.trava);
+        while (servidor.qtd_prontas == 0 && !atomic_load(&servidor.encerrar)) {
+            pthread_cond_wait(&servidor.tem_conexao, &servidor.trava);
+        }
+        if (atomic_load(&servidor.encerrar)) {
+            pthread_mutex_unlock(&servidor.trava);
+            break;
+        }
+        Conexao *c = servidor.prontas[0];
+        servidor.qtd_prontas--;
+        memmove(servidor.prontas, servidor.prontas + 1, servidor.qtd_prontas * sizeof(Conexao *));
+        pthread_mutex_unlock(&servidor.trava);
+        int status = servidor_atender(c);
+        pthread_mutex_lock(&servidor.trava);
+        if (status < 0) {
+            c->fechada = 1;
+        } else {
+            c->escrita = status;
+            c->ocupada = 0;
+        }
+        pthread_mutex_unlock(&servidor.trava);
+        servidor_acordar();
+    }
+    return NULL;
+}
+
+static void conexao_liberar(Conexao *c) {
+    close(c->fd);
+    free(c->entrada.dados);
+    free(c->saida.dados);
+    free(c);
 }
 
+/*
+ * Escuta em "caminho" com "qtd_threads" threads (0 = uma por núcleo) até
+ * receber o comando ENCERRAR. Retorna 0 se encerrou normalmente.
+ */
+int servidor_executar(const char *caminho, int qtd_threads) {
+    struct sockaddr_un endereco;
+    memset(&endereco, 0, sizeof(endereco));
+    endereco.sun_family = AF_UNIX;
+    if (strlen(caminho) >= sizeof(endereco.sun_path)) {
+        printf("ERRO: caminho do socket muito longo\n");
+        return 1;
+    }
+    strcpy(endereco.sun_path, caminho);
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        perror("socket");
+        return 1;
+    }
+    unlink(caminho);
+    if (bind(fd, (struct sockaddr *)&endereco, sizeof(endereco)) != 0 || listen(fd, 64) != 0) {
+        perror("bind/listen");
+        close(fd);
+        return 1;
+    }
+    if (qtd_threads <= 0) qtd_threads = calc_num_nucleos();
+    if (pipe(servidor.acordar) != 0) {
+        perror("pipe");
+        close(fd);
+        return 1;
+    }
+    fcntl(servidor.acordar[0], F_SETFL, O_NONBLOCK);
+    fcntl(servidor.acordar[1], F_SETFL, O_NONBLOCK);
+    servidor.socket_escuta = fd;
+    atomic_init(&servidor.encerrar, 0);
+    pthread_mutex_init(&servidor.trava, NULL);
+    pthread_cond_init(&servidor.tem_conexao, NULL);
+    pthread_t *threads = (pthread_t *)malloc(qtd_threads * sizeof(pthread_t));
+    Conexao **abertas = (Conexao **)malloc(SERVIDOR_MAX_CONEXOES * sizeof(Conexao *));
+    Conexao **vigiadas = (Conexao **)malloc(SERVIDOR_MAX_CONEXOES * sizeof(Conexao *));
+    struct pollfd *eventos = (struct pollfd *)malloc((SERVIDOR_MAX_CONEXOES + 2) * sizeof(struct pollfd));
+    int qtd_abertas = 0;
+    int criadas = 0;
+    while (threads && abertas && vigiadas && eventos && criadas < qtd_threads
+           && pthread_create(&threads[criadas], NULL, servidor_trabalhador, NULL) == 0) {
+        criadas++;
+    }
+    if (criadas == 0) {
+        printf("ERRO: nao foi possivel criar as threads do servidor\n");
+        atomic_store(&servidor.encerrar, 1);
+    } else {
+        printf("Servidor ouvindo em '%s' com %d thread(s). Envie ENCERRAR para parar.\n",
+               caminho, criadas);
+        fflush(stdout);
+    }
+    while (!atomic_load(&servidor.encerrar)) {
+        /* Fecha as conexões encerradas e vigia as que nenhuma thread atende. */
+        int qtd_eventos = 2, qtd_vigiadas = 0;
+        eventos[0].fd = fd;
+        eventos[0].events = POLLIN;
+        eventos[1].fd = servidor.acordar[0];
+        eventos[1].events = POLLIN;
+        pthread_mutex_lock(&servidor.trava);
+        for (int i = 0; i < qtd_abertas; i++) {
+            Conexao *c = abertas[i];
+            if (c->fechada) {
+                conexao_liberar(c);
+                abertas[i--] = abertas[--qtd_abertas];
+            } else if (!c->ocupada) {
+                vigiadas[qtd_vigiadas++] = c;
+                eventos[qtd_eventos].fd = c->fd;
+                eventos[qtd_eventos].events = c->escrita ? POLLOUT : POLLIN;
+                qtd_eventos++;
+            }
+        }
+        pthread_mutex_unlock(&servidor.trava);
+        if (poll(eventos, (nfds_t)qtd_eventos, -1) < 0) continue;
+        if (eventos[1].revents) {
+            char descarte[64];
+            while (read(servidor.acordar[0], descarte, sizeof(descarte)) > 0) {
+            }
+        }
+        /* Conexões prontas (dados, espaço para enviar ou fechadas) vão para o pool. */
+        pthread_mutex_lock(&servidor.trava);
+        for (int i = 0; i < qtd_vigiadas; i++) {
+            if (eventos[i + 2].revents) {
+                vigiadas[i]->ocupada = 1;
+                servidor.prontas[servidor.qtd_prontas++] = vigiadas[i];
+                pthread_cond_signal(&servidor.tem_conexao);
+            }
+        }
+        pthread_mutex_unlock(&servidor.trava);
+        if (eventos[0].revents) {
+            int cliente = accept(fd, NULL, NULL);
+            if (cliente < 0) continue;
+            Conexao *c = (qtd_abertas < SERVIDOR_MAX_CONEXOES)
+                             ? (Conexao *)calloc(1, sizeof(Conexao)) : NULL;
+            if (!c) {
+                ssize_t enviados = send(cliente, "ERRO servidor ocupado\n", 22,
+                                        MSG_NOSIGNAL | MSG_DONTWAIT);
+                (void)enviados;
+                close(cliente);
+                continue;
+            }
+            fcntl(cliente, F_SETFL, fcntl(cliente, F_GETFL) | O_NONBLOCK);
+            c->fd = cliente;
+            pthread_mutex_lock(&servidor.trava);
+            abertas[qtd_abertas++] = c;
+            servidor.conexoes++;
+            pthread_mutex_unlock(&servidor.trava);
+        }
+    }
+    pthread_mutex_lock(&servidor.trava);
+    pthread_cond_broadcast(&servidor.tem_conexao);
+    pthread_mutex_unlock(&servidor.trava);
+    for (int i = 0; i < criadas; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    for (int i = 0; i < qtd_abertas; i++) {
+        conexao_liberar(abertas[i]);
+    }
+    free(threads);
+    free(abertas);
+    free(vigiadas);
+    free(eventos);
+    close(fd);
+    close(servidor.acordar[0]);
+    close(servidor.acordar[1]);
+    unlink(caminho);
+    pthread_cond_destroy(&servidor.tem_conexao);
+    pthread_mutex_destroy(&servidor.trava);
+    printf("Servidor encerrado: %llu pedido(s), %llu erro(s).\n", servidor.pedidos, servidor.erros);
+    return 0;
+}
+#endif
+
 /* ------------------------------
         MAIN PRINCIPAL
 --------------------------------- */
-int main() {
+#ifndef CALC_FUZZ
+/*
+ * Sem argumentos abre o menu interativo. Opções:
+ *   --cache-mb N                   limite de memória do cache de resultados
+ *   --cache-dir DIR                grava/consulta o cache também em DIR
+ * Modos não interativos:
+ *   --autoteste [segundos] [seed]  verificação dos núcleos por tempo limitado
+ *   --caso                         verifica um caso lido da entrada padrão (AFL)
+ *   --servidor SOCKET [threads]    atende pedidos em um socket Unix (só POSIX)
+ */
+int main(int argc, char **argv) {
+    int arg = 1;
+    while (arg + 1 < argc) {
+        if (strcmp(argv[arg], "--cache-mb") == 0) {
+            cache_configurar((size_t)atol(argv[arg + 1]) * 1024u * 1024u, NULL);
+        } else if (strcmp(argv[arg], "--cache-dir") == 0) {
+            cache_configurar(0, argv[arg + 1]);
+        } else {
+            break;
+        }
+        arg += 2;
+    }
+    if (arg < argc && strcmp(argv[arg], "--autoteste") == 0) {
+        double segundos = (arg + 1 < argc) ? atof(argv[arg + 1]) : 10.0;
+        uint64_t semente = (arg + 2 < argc) ? strtoull(argv[arg + 2], NULL, 10) : (uint64_t)time(NULL);
+        return big_autoteste(segundos, semente) ? 0 : 1;
+    }
+    if (arg < argc && strcmp(argv[arg], "--caso") == 0) {
+        return autoteste_entrada_padrao() ? 0 : 1;
+    }
+    if (arg < argc && strcmp(argv[arg], "--servidor") == 0) {
+#ifdef CALC_SERVIDOR
+        if (arg + 1 >= argc) {
+            printf("Uso: %s --servidor SOCKET [threads]\n", argv[0]);
+            return 1;
+        }
+        return servidor_executar(argv[arg + 1], (arg + 2 < argc) ? atoi(argv[arg + 2]) : 0);
+#else
+        printf("ERRO: modo servidor indisponivel nesta plataforma.\n");
+        return 1;
+#endif
+    }
 
     int opc = 1;
     while (opc) {
@@ -847,3 +4055,4 @@ int main() {
     }
     return 0;
 }
+#endif